@@ -0,0 +1,98 @@
+#ifndef __ASYNCON__H__
+#define __ASYNCON__H__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "channel.h"
+
+/*
+十四、复用线程的 asyncOn：替代 std::async(std::launch::async, ...)
+    testAsync/testPromise/testPackageTask 每次调用都会新建一个线程（std::async 的 launch::async 在 libstdc++ 中
+就是 new 一个 std::thread），创建 + 销毁线程的开销是几十微秒，远大于很多异步任务本身。
+    asyncOn(executor, fn, args...)：
+        1. 把 fn(args...) 封装进 std::packaged_task，投递到 Executor 的任务通道，由常驻工作线程执行；
+        2. 返回 std::future<R>，语义与 std::async 相同：get() 阻塞等待结果，任务中抛出的异常在 get() 时重新抛出；
+        3. 参数按值保存（与 std::async 一致，需要传引用请用 std::ref/std::cref）。
+    defaultExecutor() 是进程内唯一的默认执行器，线程数等于逻辑核数，第一次使用时创建。
+    与 std::async 的区别：
+        a. 返回的 future 析构时不会阻塞等待任务结束（std::async 返回的 future 会）。
+        b. 不要在工作线程中同步等待提交到同一执行器的任务，所有工作线程都在等待时会死锁。
+*/
+class Executor {
+public:
+    explicit Executor(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // 投递一个无返回值的任务；执行器已关闭时抛出 std::runtime_error。
+    // 任务抛出的异常在工作线程中被捕获并丢弃（工作线程继续运行），需要拿到异常时用 asyncOn
+    template<typename F>
+    void execute(F&& f) {
+        std::unique_ptr<TaskBase> task(new Task<std::decay_t<F>>(std::forward<F>(f)));
+        if (!tasks.send(std::move(task)))
+            throw std::runtime_error("execute on stopped Executor");
+    }
+
+    // 停止接收新任务，执行完已提交的任务后回收所有线程（析构时自动调用）
+    void shutdown();
+
+    std::size_t size() const { return workers.size(); }
+
+private:
+    // 类型擦除的只移动任务：std::function 要求可拷贝，装不下 std::packaged_task
+    struct TaskBase {
+        virtual ~TaskBase() = default;
+        virtual void run() = 0;
+    };
+    template<typename F>
+    struct Task : TaskBase {
+        explicit Task(F&& f) : fn(std::move(f)) {}
+        explicit Task(const F& f) : fn(f) {}
+        void run() override { fn(); }
+        F fn;
+    };
+
+    void worker();
+
+    Channel<std::unique_ptr<TaskBase>> tasks; // 无界任务通道
+    std::vector<std::thread> workers;
+};
+
+// 进程内唯一的默认执行器
+Executor& defaultExecutor();
+
+template<typename F, typename... Args>
+auto asyncOn(Executor& executor, F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+{
+    using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+    // 与 std::async 一样按值保存可调用对象和参数，在工作线程中以右值调用
+    std::packaged_task<R()> task(
+        [fn = std::forward<F>(f), tup = std::make_tuple(std::forward<Args>(args)...)]() mutable -> R {
+            return std::apply(std::move(fn), std::move(tup));
+        });
+    std::future<R> result = task.get_future();
+    executor.execute(std::move(task));
+    return result;
+}
+
+template<typename F, typename... Args>
+auto asyncOn(F&& f, Args&&... args) {
+    return asyncOn(defaultExecutor(), std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 基准测试：calls 次异步调用（每批最多 1000 个在途 future），对比 std::async(std::launch::async) 与 asyncOn
+void benchAsyncOn(std::size_t calls = 100000);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef __CACHELINE__H__
+#define __CACHELINE__H__
+
+#include <cstddef>
+
+// 缓存行大小，用于隔离被不同线程频繁写入的变量，避免伪共享（false sharing）
+// （std::hardware_destructive_interference_size 在 GCC 中会触发 ABI 警告，这里直接写死 x86/ARM 常见的 64 字节）
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+#endif
@@ -0,0 +1,447 @@
+#ifndef __CHANNEL__H__
+#define __CHANNEL__H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "cacheLine.h"
+
+/*
+七、高吞吐 MPMC 通道 Channel<T>
+    main.cpp 中的 producer/consumer 共享一个 std::queue + 一把锁 + 两个条件变量，每个元素都要加锁、解锁、notify，
+还在锁内打印，吞吐量被锁竞争和系统调用限制住了。Channel<T> 的思路：
+    1. 数据通路：Vyukov 有界 MPMC 无锁环形队列（MpmcRing）
+        每个槽位带一个序号 seq，生产者/消费者只通过 CAS 推进 enqueuePos/dequeuePos 抢占槽位，再用 release 写 seq 发布，
+    不需要任何锁。批量操作一次 CAS 抢占连续的 k 个槽位，减少 CAS 次数。
+    2. 阻塞通路：EventCount
+        只有在队列满/空时才真正睡眠；没有等待者时 notify 只是一次原子读，不会进内核。
+    3. 关闭语义 close()
+        关闭后 send 返回 false；recv 会先把剩余元素取完，取空后才返回 false，保证不丢数据。
+    4. 有界 / 无界
+        有界：容量向上取整为 2 的幂，满了 send 阻塞。
+        无界：环形队列作为快速通道，环满时溢出到一个由互斥锁保护的 spill 队列（只在消费者跟不上时才会走到这条慢路径）。
+    为保证同一生产者的 FIFO 顺序，spill 非空期间所有生产者都写 spill，消费者只在环“真正为空”时才从 spill 取。
+*/
+
+// Vyukov 有界 MPMC 队列
+template<typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(std::size_t capacity)
+        : mask(roundUpPow2(capacity) - 1), cells(new Cell[mask + 1]) {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    bool tryPush(T&& value) {
+        Cell* cell;
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (dif == 0) {
+                // 槽位空闲，尝试抢占
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (dif < 0) {
+                return false; // 上一圈的数据还没被消费：队列满
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed); // 被其他生产者抢先，重新读取
+            }
+        }
+        cell->data = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release); // 发布：消费者看到 seq == pos + 1 即可读取
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        Cell* cell;
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (dif < 0) {
+                return false; // 空，或生产者已抢占但尚未发布
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->data);
+        cell->seq.store(pos + mask + 1, std::memory_order_release); // 归还槽位给下一圈的生产者
+        return true;
+    }
+
+    // 批量写入：一次 CAS 抢占连续的空闲槽位，返回实际写入个数，first 前进相应步数
+    template<typename It>
+    std::size_t tryPushN(It& first, std::size_t n) {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            std::size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+            std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (dif < 0) return 0;
+            if (dif > 0) {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            std::size_t k = 1;
+            while (k < n && k <= mask && cells[(pos + k) & mask].seq.load(std::memory_order_acquire) == pos + k)
+                ++k;
+            if (enqueuePos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < k; ++i, ++first) {
+                    Cell& cell = cells[(pos + i) & mask];
+                    cell.data = std::move(*first);
+                    cell.seq.store(pos + i + 1, std::memory_order_release);
+                }
+                return k;
+            }
+        }
+    }
+
+    // 批量读取：一次 CAS 抢占连续的已发布槽位，返回实际读取个数
+    template<typename OutIt>
+    std::size_t tryPopN(OutIt& out, std::size_t n) {
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            std::size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+            std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (dif < 0) return 0;
+            if (dif > 0) {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            std::size_t k = 1;
+            while (k < n && k <= mask && cells[(pos + k) & mask].seq.load(std::memory_order_acquire) == pos + k + 1)
+                ++k;
+            if (dequeuePos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < k; ++i, ++out) {
+                    Cell& cell = cells[(pos + i) & mask];
+                    *out = std::move(cell.data);
+                    cell.seq.store(pos + i + mask + 1, std::memory_order_release);
+                }
+                return k;
+            }
+        }
+    }
+
+    // 环中没有任何已抢占但未被取走的元素（包括生产者抢占了但还没发布的槽位）
+    bool drained() const {
+        std::size_t enq = enqueuePos.load(std::memory_order_acquire);
+        return dequeuePos.load(std::memory_order_acquire) >= enq;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    // 两个位置索引分别被生产者、消费者频繁 CAS，放在不同缓存行上
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueuePos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeuePos{0};
+};
+
+/*
+EventCount：无锁数据结构的“条件变量”
+    等待方：key = prepareWait(); 再检查一次条件; 条件仍不满足才 wait(key)，否则 cancelWait()。
+    通知方：修改数据后 notifyAll()，没有等待者时只有一次 fence + 原子读。
+    prepareWait 之后发生的任何 notify 都会改变 epoch，因此不会丢失唤醒。
+*/
+class EventCount {
+public:
+    std::uint64_t prepareWait() {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        return epoch.load(std::memory_order_seq_cst);
+    }
+
+    void cancelWait() { waiters.fetch_sub(1, std::memory_order_seq_cst); }
+
+    void wait(std::uint64_t key) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() { return epoch.load(std::memory_order_relaxed) != key; });
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void notifyAll() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) == 0)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            epoch.fetch_add(1, std::memory_order_relaxed);
+        }
+        cv.notify_all();
+    }
+
+private:
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<int> waiters{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+template<typename T>
+class Channel {
+public:
+    static constexpr std::size_t UNBOUNDED = 0;
+    // 无界模式下快速通道（环形队列）的容量
+    static constexpr std::size_t UNBOUNDED_RING_SIZE = 4096;
+
+    explicit Channel(std::size_t capacity = UNBOUNDED)
+        : bounded(capacity != UNBOUNDED), ring(bounded ? capacity : UNBOUNDED_RING_SIZE) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // 发送一个元素；有界且满时阻塞。通道已关闭返回 false
+    bool send(T value) {
+        SendGuard guard(*this);
+        if (!guard.admitted) return false;
+        if (!bounded) {
+            pushUnbounded(std::move(value));
+            notEmpty.notifyAll();
+            return true;
+        }
+        for (int spin = 0; !ring.tryPush(std::move(value)); ++spin) {
+            if (spin < SPIN_LIMIT) {
+                spinPause(spin);
+                continue;
+            }
+            std::uint64_t key = notFull.prepareWait();
+            if (ring.tryPush(std::move(value))) {
+                notFull.cancelWait();
+                break;
+            }
+            if (closed.load(std::memory_order_seq_cst)) {
+                notFull.cancelWait();
+                return false;
+            }
+            notFull.wait(key);
+        }
+        notEmpty.notifyAll();
+        return true;
+    }
+
+    // 非阻塞发送；满或已关闭返回 false（失败时 value 保持不变）
+    bool trySend(T& value) {
+        SendGuard guard(*this);
+        if (!guard.admitted) return false;
+        if (!bounded) {
+            pushUnbounded(std::move(value));
+        } else if (!ring.tryPush(std::move(value))) {
+            return false;
+        }
+        notEmpty.notifyAll();
+        return true;
+    }
+
+    // 批量发送 [first, first + n)，返回实际发送个数（只有通道中途关闭时才会小于 n）
+    template<typename It>
+    std::size_t sendN(It first, std::size_t n) {
+        SendGuard guard(*this);
+        if (!guard.admitted) return 0;
+        std::size_t sent = 0;
+        int spin = 0;
+        while (sent < n) {
+            std::size_t k = 0;
+            if (!spilling.load(std::memory_order_acquire))
+                k = ring.tryPushN(first, n - sent);
+            if (k > 0) {
+                sent += k;
+                spin = 0;
+                notEmpty.notifyAll();
+                continue;
+            }
+            if (!bounded) {
+                for (; sent < n; ++sent, ++first)
+                    pushUnbounded(std::move(*first));
+                notEmpty.notifyAll();
+                break;
+            }
+            if (spin < SPIN_LIMIT) {
+                spinPause(spin++);
+                continue;
+            }
+            std::uint64_t key = notFull.prepareWait();
+            k = ring.tryPushN(first, n - sent);
+            if (k > 0) {
+                notFull.cancelWait();
+                sent += k;
+                notEmpty.notifyAll();
+                continue;
+            }
+            if (closed.load(std::memory_order_seq_cst)) {
+                notFull.cancelWait();
+                break;
+            }
+            notFull.wait(key);
+        }
+        return sent;
+    }
+
+    // 接收一个元素；空时阻塞。通道关闭且已取空时返回 false
+    bool recv(T& out) {
+        T* dst = &out;
+        return recvN(dst, 1) == 1;
+    }
+
+    // 非阻塞接收
+    bool tryRecv(T& out) {
+        T* dst = &out;
+        return tryRecvN(dst, 1) == 1;
+    }
+
+    // 批量接收：阻塞直到至少有一个元素，最多取 maxN 个写入 out；返回 0 表示通道关闭且已取空
+    template<typename OutIt>
+    std::size_t recvN(OutIt out, std::size_t maxN) {
+        if (maxN == 0) return 0;
+        for (int spin = 0;; ++spin) {
+            std::size_t k = tryRecvN(out, maxN);
+            if (k > 0) return k;
+            if (spin < SPIN_LIMIT) {
+                spinPause(spin);
+                continue;
+            }
+            std::uint64_t key = notEmpty.prepareWait();
+            k = tryRecvN(out, maxN);
+            if (k > 0) {
+                notEmpty.cancelWait();
+                return k;
+            }
+            if (isDrained()) {
+                notEmpty.cancelWait();
+                return 0;
+            }
+            notEmpty.wait(key);
+        }
+    }
+
+    // 关闭通道：唤醒所有阻塞中的发送者和接收者
+    void close() {
+        closed.store(true, std::memory_order_seq_cst);
+        notFull.notifyAll();
+        notEmpty.notifyAll();
+    }
+
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+    std::size_t capacity() const { return bounded ? ring.capacity() : UNBOUNDED; }
+
+private:
+    static constexpr int SPIN_LIMIT = 64;
+
+    // 记录“正在发送”的线程数，保证 close 之后接收方不会在有在途元素时误判为已取空
+    struct SendGuard {
+        Channel& ch;
+        bool admitted;
+        explicit SendGuard(Channel& c) : ch(c) {
+            ch.activeSenders.fetch_add(1, std::memory_order_seq_cst);
+            admitted = !ch.closed.load(std::memory_order_seq_cst);
+        }
+        ~SendGuard() {
+            if (ch.activeSenders.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+                ch.closed.load(std::memory_order_seq_cst))
+                ch.notEmpty.notifyAll(); // 最后一个在途发送者离开，让等待“关闭且取空”的接收者复查
+        }
+    };
+
+    static void spinPause(int spin) {
+        if (spin < SPIN_LIMIT / 2) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename OutIt>
+    std::size_t tryRecvN(OutIt& out, std::size_t maxN) {
+        std::size_t k = ring.tryPopN(out, maxN);
+        if (k == 0 && !bounded)
+            k = popSpill(out, maxN);
+        if (k > 0 && bounded)
+            notFull.notifyAll();
+        return k;
+    }
+
+    bool isDrained() {
+        if (!closed.load(std::memory_order_seq_cst) || activeSenders.load(std::memory_order_seq_cst) != 0)
+            return false;
+        if (!ring.drained()) return false;
+        std::lock_guard<std::mutex> lock(spillMutex);
+        return spill.empty();
+    }
+
+    void pushUnbounded(T&& value) {
+        if (!spilling.load(std::memory_order_acquire) && ring.tryPush(std::move(value)))
+            return;
+        std::lock_guard<std::mutex> lock(spillMutex);
+        if (!spilling.load(std::memory_order_relaxed)) {
+            if (ring.tryPush(std::move(value)))
+                return;
+            spilling.store(true, std::memory_order_release);
+        }
+        spill.push_back(std::move(value));
+    }
+
+    template<typename OutIt>
+    std::size_t popSpill(OutIt& out, std::size_t maxN) {
+        // 环里还有更早的元素（或在途元素）时不能越过它们去取 spill，否则会打乱同一生产者的顺序
+        if (!spilling.load(std::memory_order_acquire) || !ring.drained())
+            return 0;
+        std::lock_guard<std::mutex> lock(spillMutex);
+        std::size_t k = 0;
+        while (k < maxN && !spill.empty()) {
+            *out = std::move(spill.front());
+            ++out;
+            spill.pop_front();
+            ++k;
+        }
+        if (spill.empty())
+            spilling.store(false, std::memory_order_release);
+        return k;
+    }
+
+    const bool bounded;
+    MpmcRing<T> ring;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> closed{false};
+    std::atomic<int> activeSenders{0};
+    std::atomic<bool> spilling{false};
+
+    std::mutex spillMutex;
+    std::deque<T> spill; // 无界模式的溢出队列
+
+    EventCount notEmpty; // 消费者在此等待“有数据”
+    EventCount notFull;  // 有界模式下生产者在此等待“有空位”
+};
+
+// 基准测试：totalItems 个元素在 1~16 个生产者/消费者之间传递，输出 items/sec
+void benchChannel(std::size_t totalItems = 100000000);
+
+#endif
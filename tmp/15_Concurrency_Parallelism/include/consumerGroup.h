@@ -0,0 +1,92 @@
+#ifndef __CONSUMERGROUP__H__
+#define __CONSUMERGROUP__H__
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "channel.h"
+
+/*
+九、可优雅结束的消费者组 ConsumerGroup<T>
+    main.cpp 中的 consumer() 是 while(true) 死循环并且被 detach()，它永远不会退出，进程结束时它可能还在运行，
+也无法知道数据是否被全部处理。批处理任务需要“全部处理完再确定性地结束”：
+    1. 关闭即毒丸（poison pill）：生产者全部结束后调用 Channel::close()，相当于给每个消费者投递一个毒丸，
+       消费者取空剩余数据后 recvN 返回 0，自然退出循环。不需要为每个消费者单独塞一个特殊值，也不要求 T 有“非法值”。
+    2. 可 join：ConsumerGroup 持有所有消费者线程，join() 等待它们全部退出；析构时自动 join（RAII），不会再有 detach。
+       析构时先关闭通道再 join：生产者在 close() 之前抛出异常、栈展开到这里时，消费者不会永远等在空通道上。
+    3. 批量取出：每次唤醒用 recvN 最多取 batchSize 个元素交给 handler，一次唤醒的开销被一整批数据摊薄。
+    4. 异常：handler 抛出的第一个异常被保存下来，消费者继续取空通道（保证流水线能结束），join() 时重新抛出。
+*/
+template<typename T>
+class ConsumerGroup {
+public:
+    // handler(items, count)：处理一批元素
+    using BatchHandler = std::function<void(T* items, std::size_t count)>;
+
+    ConsumerGroup(Channel<T>& channel, std::size_t consumerCount, BatchHandler handler, std::size_t batchSize = 256)
+        : channel(channel), handler(std::move(handler)), batchSize(batchSize == 0 ? 1 : batchSize) {
+        for (std::size_t i = 0; i < consumerCount; ++i)
+            consumers.emplace_back(&ConsumerGroup::consume, this);
+    }
+
+    ConsumerGroup(const ConsumerGroup&) = delete;
+    ConsumerGroup& operator=(const ConsumerGroup&) = delete;
+
+    ~ConsumerGroup() {
+        // 析构时不能抛异常：没被 join() 取走的异常在这里丢弃
+        channel.close(); // 正常路径上通道已关闭，重复 close 无副作用
+        joinThreads();
+    }
+
+    // 等待通道关闭并取空、所有消费者退出；若 handler 抛过异常则在此重新抛出
+    void join() {
+        joinThreads();
+        std::exception_ptr e;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            std::swap(e, firstError);
+        }
+        if (e) std::rethrow_exception(e);
+    }
+
+    // 已处理的元素个数
+    std::size_t processed() const { return processedCount.load(std::memory_order_relaxed); }
+
+private:
+    void consume() {
+        std::vector<T> batch(batchSize);
+        std::size_t k;
+        while ((k = channel.recvN(batch.begin(), batchSize)) > 0) {
+            try {
+                handler(batch.data(), k);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) firstError = std::current_exception();
+            }
+            processedCount.fetch_add(k, std::memory_order_relaxed);
+        }
+    }
+
+    void joinThreads() {
+        for (auto& t : consumers) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    Channel<T>& channel;
+    BatchHandler handler;
+    const std::size_t batchSize;
+    std::vector<std::thread> consumers;
+    std::atomic<std::size_t> processedCount{0};
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+};
+
+// 基准测试：totalItems 个元素的流水线从第一个元素发送到最后一个消费者退出的端到端耗时
+void benchPipeline(std::size_t totalItems = 10000000);
+
+#endif
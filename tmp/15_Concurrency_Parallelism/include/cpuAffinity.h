@@ -0,0 +1,18 @@
+#ifndef __CPUAFFINITY__H__
+#define __CPUAFFINITY__H__
+
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+// 将当前线程绑定到指定 CPU（超出逻辑核数时取模），使基准测试/测试线程固定在确定的核心上，结果更稳定
+inline void pinCurrentThread(unsigned cpu) {
+    unsigned n = std::thread::hardware_concurrency();
+    if (n == 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % n, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef __FUTEX__H__
+#define __FUTEX__H__
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+futex（fast userspace mutex）
+    Linux 提供的最底层等待/唤醒原语，std::mutex、std::condition_variable 在 glibc 中最终也是基于它实现的。
+    1. futexWait(addr, expected)：只有当 *addr == expected 时才睡眠（检查与睡眠在内核中是原子的），否则立即返回，
+       因此“检查条件 -> 睡眠”之间不会丢失唤醒。
+    2. futexWake(addr, n)：唤醒最多 n 个在 addr 上睡眠的线程。
+    3. 快路径（无竞争）完全在用户态完成，只有真正需要睡眠/唤醒时才进入内核。
+    这里使用 *_PRIVATE 版本，表示 futex 只在本进程内共享，内核可以省去跨进程查找。
+*/
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "std::atomic<uint32_t> must have the same layout as uint32_t to be used as a futex word");
+
+// 返回 0 表示被唤醒（或虚假唤醒），-1 表示 *addr != expected、超时或被信号打断（见 errno）
+inline int futexWait(std::atomic<std::uint32_t>* addr, std::uint32_t expected, const timespec* timeout = nullptr) {
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr),
+                                    FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0));
+}
+
+// 返回实际唤醒的线程数
+inline int futexWake(std::atomic<std::uint32_t>* addr, int count = INT_MAX) {
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr),
+                                    FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0));
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef __FUTEXMUTEX__H__
+#define __FUTEXMUTEX__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include "cacheLine.h"
+#include "futex.h"
+
+/*
+十三、基于 futex 的轻量级互斥锁、信号量与事件
+    mtx_pc 保护的临界区只有 data_queue.push/pop 几条指令，真正的开销在于：拿不到锁就进内核睡眠、
+释放时进内核唤醒，一次 futex 唤醒 + 调度的代价远大于临界区本身。
+    1. SpinFutexMutex：三态锁（0 未加锁，1 加锁无等待者，2 加锁且可能有等待者）
+        lock：先 CAS 0->1；失败则自适应自旋——临界区很短时，持锁者很快就会释放，自旋等一会儿比睡眠划算；
+              自旋上限根据最近几次“自旋多久才拿到锁”的滑动平均动态调整（与 glibc 的 PTHREAD_MUTEX_ADAPTIVE_NP 思路一致）；
+              仍拿不到则把状态置为 2 并 futexWait。
+        unlock：exchange(0)，只有旧值为 2（可能有人在睡）时才 futexWake，无竞争时完全不进内核。
+    2. FutexSemaphore：计数信号量，post 只有在有等待者时才进内核。
+    3. FutexEvent：手动复位事件，set 唤醒所有等待者，直到 reset 前 wait 都立即返回。
+    接口命名与 std::mutex 一致（lock/try_lock/unlock），可直接配合 std::lock_guard、std::unique_lock 使用。
+*/
+
+inline void futexCpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// 单核机器上自旋只会拖延持锁者/通知方运行，直接睡眠更好
+inline int futexSpinBudget(int n) {
+    static const bool multiCore = std::thread::hardware_concurrency() > 1;
+    return multiCore ? n : 0;
+}
+
+class SpinFutexMutex {
+public:
+    SpinFutexMutex() = default;
+    SpinFutexMutex(const SpinFutexMutex&) = delete;
+    SpinFutexMutex& operator=(const SpinFutexMutex&) = delete;
+
+    bool try_lock() {
+        std::uint32_t expected = 0;
+        return state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void lock() {
+        if (try_lock()) return;
+
+        // 自适应自旋：上限为 2 倍历史平均自旋次数 + 10，不超过 MAX_SPIN
+        int estimate = spinEstimate.load(std::memory_order_relaxed);
+        int limit = futexSpinBudget(estimate * 2 + 10 < MAX_SPIN ? estimate * 2 + 10 : MAX_SPIN);
+        for (int spin = 1; spin <= limit; ++spin) {
+            futexCpuRelax();
+            if (state.load(std::memory_order_relaxed) == 0 && try_lock()) {
+                spinEstimate.store(estimate + (spin - estimate) / 8, std::memory_order_relaxed);
+                return;
+            }
+        }
+        spinEstimate.store(estimate + (limit - estimate) / 8, std::memory_order_relaxed);
+
+        // 慢路径：标记“有等待者”后睡眠。醒来后仍以 2 抢锁，保证释放时会唤醒其他可能的等待者
+        while (state.exchange(2, std::memory_order_acquire) != 0)
+            futexWait(&state, 2);
+    }
+
+    void unlock() {
+        if (state.exchange(0, std::memory_order_release) == 2)
+            futexWake(&state, 1);
+    }
+
+private:
+    static constexpr int MAX_SPIN = 1000;
+    std::atomic<std::uint32_t> state{0};
+    std::atomic<int> spinEstimate{0}; // 只用于启发式，允许不精确
+};
+
+class FutexSemaphore {
+public:
+    explicit FutexSemaphore(std::uint32_t initial = 0) : count(initial) {}
+    FutexSemaphore(const FutexSemaphore&) = delete;
+    FutexSemaphore& operator=(const FutexSemaphore&) = delete;
+
+    void post() {
+        count.fetch_add(1, std::memory_order_release);
+        // 与 wait 中的“waiters++ -> 检查 count”配对，seq_cst 保证二者至少一方看到对方
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0)
+            futexWake(&count, 1);
+    }
+
+    bool tryWait() {
+        std::uint32_t c = count.load(std::memory_order_relaxed);
+        while (c > 0) {
+            if (count.compare_exchange_weak(c, c - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    void wait() {
+        for (int spin = 0, limit = futexSpinBudget(SPIN); spin < limit; ++spin) {
+            if (tryWait()) return;
+            futexCpuRelax();
+        }
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!tryWait())
+            futexWait(&count, 0); // count 仍为 0 才睡眠
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int SPIN = 100;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> count;
+    std::atomic<std::uint32_t> waiters{0};
+};
+
+class FutexEvent {
+public:
+    FutexEvent() = default;
+    FutexEvent(const FutexEvent&) = delete;
+    FutexEvent& operator=(const FutexEvent&) = delete;
+
+    void set() {
+        if (state.exchange(1, std::memory_order_release) == 0) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) > 0)
+                futexWake(&state);
+        }
+    }
+
+    void reset() { state.store(0, std::memory_order_relaxed); }
+
+    bool isSet() const { return state.load(std::memory_order_acquire) == 1; }
+
+    void wait() {
+        for (int spin = 0, limit = futexSpinBudget(SPIN); spin < limit; ++spin) {
+            if (isSet()) return;
+            futexCpuRelax();
+        }
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!isSet())
+            futexWait(&state, 0);
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int SPIN = 100;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> state{0};
+    std::atomic<std::uint32_t> waiters{0};
+};
+
+// 基准测试：短临界区下的加锁吞吐（每次加解锁平均耗时）与两线程之间的唤醒交接延迟
+void benchFutexPrimitives(std::size_t iterations = 1000000);
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef __LIGHTFUTURE__H__
+#define __LIGHTFUTURE__H__
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "futex.h"
+#include "futexMutex.h"
+
+/*
+十五、轻量级 promise/future：不在堆上分配共享状态
+    std::promise/std::future（computeAnswer2、ThreadPool::enqueue 都在用）每对都要 new 一个共享状态，
+并且内部用 mutex + condition_variable 同步：一次“设置值 -> 取值”要经过一次堆分配、若干次加解锁。
+    LightPromise<T>/LightFuture<T>：
+    1. 共享状态 FutureSlot<T> 由调用者提供（例如放在栈上或任务对象里），或者从按类型划分的对象池 SlotPool<T> 中取，
+       池中的槽位按 64 个一块成批分配，并带线程本地缓存，常见路径不加锁也不调用 malloc。
+    2. 同步只用一个原子状态字：PENDING / VALUE / EXCEPTION，外加一个 WAITER 位表示“有人在睡”；
+       设置结果时 exchange 状态字，只有看到 WAITER 位才 futexWake，取值方先自旋一会儿再 futexWait。
+    3. 支持 wait_for/wait_until（对应 testOuttime 中的 fut.wait_for），返回 std::future_status。
+    4. 语义与 std 版本保持一致：get() 只能调用一次；promise 未设置结果就被销毁时，future 得到 broken_promise 异常。
+    注意：调用者提供槽位时，必须保证槽位比 promise 和 future 都活得久；池化槽位由引用计数在两端都销毁后自动归还。
+    不支持 T = void（编译时报错）：只需要“完成”信号时用一个空结构体或 bool 作为占位值。
+*/
+
+template<typename T> class SlotPool;
+
+#define LIGHT_FUTURE_NOT_VOID(T) \
+    static_assert(!std::is_void_v<T>, "LightFuture<void> 不受支持：只需要完成信号时请用空结构体或 bool 作为值类型")
+
+template<typename T>
+class FutureSlot {
+    LIGHT_FUTURE_NOT_VOID(T);
+
+public:
+    FutureSlot() = default;
+    FutureSlot(const FutureSlot&) = delete;
+    FutureSlot& operator=(const FutureSlot&) = delete;
+    ~FutureSlot() { destroyValue(); }
+
+    // 复用调用者提供的槽位：必须在上一对 promise/future 都销毁之后调用
+    void reset() { recycle(); }
+
+private:
+    template<typename> friend class LightPromise;
+    template<typename> friend class LightFuture;
+    template<typename> friend class SlotPool;
+
+    enum : std::uint32_t { PENDING = 0, VALUE = 1, EXCEPTION = 2, READY_MASK = 3, WAITER = 4 };
+
+    void destroyValue() {
+        if ((state.load(std::memory_order_relaxed) & READY_MASK) == VALUE && !consumed)
+            reinterpret_cast<T*>(&storage)->~T();
+    }
+
+    // 复位以便复用（只在两端都已释放后调用）
+    void recycle() {
+        destroyValue();
+        error = nullptr;
+        consumed = false;
+        state.store(PENDING, std::memory_order_relaxed);
+    }
+
+    void publish(std::uint32_t result) {
+        std::uint32_t old = state.exchange(result, std::memory_order_acq_rel);
+        if (old & WAITER)
+            futexWake(&state);
+    }
+
+    std::uint32_t spinForResult() const {
+        for (int spin = 0, limit = futexSpinBudget(SPIN); spin < limit; ++spin) {
+            std::uint32_t s = state.load(std::memory_order_acquire);
+            if (s & READY_MASK) return s;
+            futexCpuRelax();
+        }
+        return state.load(std::memory_order_acquire);
+    }
+
+    void wait() {
+        std::uint32_t s = spinForResult();
+        while (!(s & READY_MASK)) {
+            // 设置 WAITER 位后睡眠；若期间结果已发布，CAS 失败或 futexWait 发现值已变化都会立即返回
+            if (s == PENDING && !state.compare_exchange_weak(s, PENDING | WAITER, std::memory_order_acquire))
+                continue;
+            futexWait(&state, PENDING | WAITER);
+            s = state.load(std::memory_order_acquire);
+        }
+    }
+
+    template<typename Clock, typename Duration>
+    std::future_status waitUntil(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::uint32_t s = spinForResult();
+        while (!(s & READY_MASK)) {
+            auto remaining = deadline - Clock::now();
+            if (remaining <= Duration::zero()) return std::future_status::timeout;
+            if (s == PENDING && !state.compare_exchange_weak(s, PENDING | WAITER, std::memory_order_acquire))
+                continue;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            timespec timeout{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+            futexWait(&state, PENDING | WAITER, &timeout); // 相对超时
+            s = state.load(std::memory_order_acquire);
+        }
+        return std::future_status::ready;
+    }
+
+    static constexpr int SPIN = 200;
+
+    std::atomic<std::uint32_t> state{PENDING};
+    std::atomic<std::uint32_t> refs{0};           // 仅池化槽位使用
+    SlotPool<T>* pool = nullptr;                  // 非空表示来自对象池
+    FutureSlot* nextFree = nullptr;               // 对象池空闲链表
+    bool consumed = false;
+    std::exception_ptr error;
+    // T 为 void 时只让上面的 static_assert 报错，不再连带出 sizeof(void) 的错误
+    using Stored = std::conditional_t<std::is_void_v<T>, char, T>;
+    typename std::aligned_storage<sizeof(Stored), alignof(Stored)>::type storage;
+};
+
+// 按类型划分的槽位池：64 个一块成批分配，线程本地缓存 + 全局空闲链表（SpinFutexMutex 保护）
+template<typename T>
+class SlotPool {
+public:
+    static SlotPool& instance() {
+        static SlotPool pool;
+        return pool;
+    }
+
+    FutureSlot<T>* acquire() {
+        LocalCache& cache = localCache();
+        if (!cache.head) refill(cache);
+        FutureSlot<T>* slot = cache.head;
+        cache.head = slot->nextFree;
+        --cache.count;
+        slot->nextFree = nullptr;
+        slot->refs.store(2, std::memory_order_relaxed); // promise + future
+        return slot;
+    }
+
+    // promise、future 各调用一次，最后一次调用把槽位归还到本线程缓存
+    void release(FutureSlot<T>* slot) {
+        if (slot->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        slot->recycle();
+        LocalCache& cache = localCache();
+        slot->nextFree = cache.head;
+        cache.head = slot;
+        if (++cache.count > 2 * BATCH) spill(cache, BATCH);
+    }
+
+private:
+    static constexpr std::size_t BATCH = 32;
+    static constexpr std::size_t CHUNK = 64;
+
+    struct LocalCache {
+        FutureSlot<T>* head = nullptr;
+        std::size_t count = 0;
+        ~LocalCache() { SlotPool::instance().spill(*this, count); } // 线程退出时全部交还全局链表
+    };
+
+    static LocalCache& localCache() {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+
+    void refill(LocalCache& cache) {
+        std::lock_guard<SpinFutexMutex> lock(mtx);
+        for (std::size_t i = 0; i < BATCH && globalFree; ++i) {
+            FutureSlot<T>* s = globalFree;
+            globalFree = s->nextFree;
+            s->nextFree = cache.head;
+            cache.head = s;
+            ++cache.count;
+        }
+        if (cache.head) return;
+        // 全局链表也空了：新分配一块。块在进程生命周期内不释放（槽位一直被复用）
+        FutureSlot<T>* chunk = new FutureSlot<T>[CHUNK];
+        for (std::size_t i = 0; i < CHUNK; ++i) {
+            chunk[i].pool = this;
+            chunk[i].nextFree = cache.head;
+            cache.head = &chunk[i];
+        }
+        cache.count += CHUNK;
+    }
+
+    void spill(LocalCache& cache, std::size_t n) {
+        std::lock_guard<SpinFutexMutex> lock(mtx);
+        for (std::size_t i = 0; i < n && cache.head; ++i) {
+            FutureSlot<T>* s = cache.head;
+            cache.head = s->nextFree;
+            --cache.count;
+            s->nextFree = globalFree;
+            globalFree = s;
+        }
+    }
+
+    SpinFutexMutex mtx;
+    FutureSlot<T>* globalFree = nullptr;
+};
+
+template<typename T>
+class LightFuture {
+    LIGHT_FUTURE_NOT_VOID(T);
+
+public:
+    LightFuture() = default;
+    LightFuture(LightFuture&& other) noexcept : slot(std::exchange(other.slot, nullptr)) {}
+    LightFuture& operator=(LightFuture&& other) noexcept {
+        if (this != &other) {
+            releaseSlot();
+            slot = std::exchange(other.slot, nullptr);
+        }
+        return *this;
+    }
+    ~LightFuture() { releaseSlot(); }
+
+    bool valid() const { return slot != nullptr; }
+
+    bool isReady() const {
+        return slot && (slot->state.load(std::memory_order_acquire) & FutureSlot<T>::READY_MASK);
+    }
+
+    void wait() const { checkValid()->wait(); }
+
+    template<typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        return checkValid()->waitUntil(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const {
+        return checkValid()->waitUntil(deadline);
+    }
+
+    // 阻塞直到结果就绪；只能调用一次，之后 valid() 为 false
+    T get() {
+        FutureSlot<T>* s = checkValid();
+        s->wait();
+        if ((s->state.load(std::memory_order_acquire) & FutureSlot<T>::READY_MASK) == FutureSlot<T>::EXCEPTION) {
+            std::exception_ptr e = s->error;
+            releaseSlot();
+            std::rethrow_exception(e);
+        }
+        T* value = reinterpret_cast<T*>(&s->storage);
+        T result(std::move(*value));
+        value->~T();
+        s->consumed = true;
+        releaseSlot();
+        return result;
+    }
+
+private:
+    template<typename> friend class LightPromise;
+    explicit LightFuture(FutureSlot<T>* s) : slot(s) {}
+
+    FutureSlot<T>* checkValid() const {
+        if (!slot) throw std::future_error(std::future_errc::no_state);
+        return slot;
+    }
+
+    void releaseSlot() {
+        if (slot && slot->pool) slot->pool->release(slot);
+        slot = nullptr;
+    }
+
+    FutureSlot<T>* slot = nullptr;
+};
+
+template<typename T>
+class LightPromise {
+    LIGHT_FUTURE_NOT_VOID(T);
+
+public:
+    // 使用调用者提供的槽位（槽位必须比 promise、future 活得久，且未被使用过）
+    explicit LightPromise(FutureSlot<T>& external) : slot(&external) {}
+    // 从对象池获取槽位
+    LightPromise() : slot(SlotPool<T>::instance().acquire()) {}
+
+    LightPromise(LightPromise&& other) noexcept
+        : slot(std::exchange(other.slot, nullptr)), futureRetrieved(other.futureRetrieved) {}
+    LightPromise& operator=(LightPromise&&) = delete;
+    LightPromise(const LightPromise&) = delete;
+
+    ~LightPromise() {
+        if (!slot) return;
+        if (!(slot->state.load(std::memory_order_relaxed) & FutureSlot<T>::READY_MASK))
+            setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        if (!futureRetrieved && slot->pool) slot->pool->release(slot); // future 从未取走：替它释放一次
+        if (slot->pool) slot->pool->release(slot);
+    }
+
+    LightFuture<T> getFuture() {
+        if (!slot) throw std::future_error(std::future_errc::no_state);
+        if (futureRetrieved) throw std::future_error(std::future_errc::future_already_retrieved);
+        futureRetrieved = true;
+        return LightFuture<T>(slot);
+    }
+
+    template<typename U>
+    void setValue(U&& value) {
+        checkUnsatisfied();
+        new (&slot->storage) T(std::forward<U>(value));
+        slot->publish(FutureSlot<T>::VALUE);
+    }
+
+    void setException(std::exception_ptr e) {
+        checkUnsatisfied();
+        slot->error = std::move(e);
+        slot->publish(FutureSlot<T>::EXCEPTION);
+    }
+
+private:
+    void checkUnsatisfied() {
+        if (!slot) throw std::future_error(std::future_errc::no_state);
+        if (slot->state.load(std::memory_order_relaxed) & FutureSlot<T>::READY_MASK)
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+    }
+
+    FutureSlot<T>* slot;
+    bool futureRetrieved = false;
+};
+
+// 基准测试：设置值 -> 取值 的平均耗时，对比 std::promise/std::future 与 LightPromise/LightFuture
+void benchLightFuture(std::size_t iterations = 1000000);
+
+#endif
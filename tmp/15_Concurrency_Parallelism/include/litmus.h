@@ -0,0 +1,234 @@
+#ifndef __LITMUS__H__
+#define __LITMUS__H__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cacheLine.h"
+#include "cpuAffinity.h"
+
+/*
+十一、内存顺序 litmus 测试工具
+    testReorder/testRelaxed/testAcuRel 每次迭代都新建两个 std::thread，创建线程要几十微秒，而被测的两条指令只要几纳秒，
+两个线程几乎不可能真正“同时”执行，所以很难观察到重排。这里的做法：
+    1. 线程常驻并绑核：每个测试只创建一次线程，绑定到不同 CPU 上，反复执行 trials 次试验。
+    2. 自旋屏障同步每次试验：所有线程在屏障处对齐后同时执行被测代码，再过一次屏障由 0 号线程记录结果并复位。
+       每次试验之前加入随机的几个 pause，让各线程的执行窗口错开不同相位，增加观察到重排的机会。
+    3. 结果直方图：每种结果（各寄存器取值的组合）出现的次数；被当前内存顺序“禁止”的结果单独标出，
+       若禁止结果出现次数不为 0，说明代码使用的内存顺序不足以保证预期的性质。
+    内置三种经典模式（模板参数为所用的内存顺序）：
+        StoreBuffering（SB）：  T0: x=1; r0=y        T1: y=1; r1=x
+            r0=0,r1=0 只在 seq_cst 下被禁止。注意 release/acquire 不能阻止它（testAcuRel 想验证的正是这一点）。
+        MessagePassing（MP）：  T0: data=1; flag=1   T1: r0=flag; r1=data
+            r0=1,r1=0 在 flag 使用 release 写、acquire 读时被禁止。
+        IRIW：                  T0: x=1   T1: y=1   T2: r0=x; r1=y   T3: r2=y; r3=x
+            r0=1,r1=0,r2=1,r3=0（两个读线程看到两次写入的顺序相反）只在 seq_cst 下被禁止。
+    自定义测试只需提供：THREADS、OUTCOMES、run(tid)、outcome()、reset()、name()、outcomeName(o)、forbidden(o)。
+*/
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// 自旋屏障：所有线程都到达后同时放行。自旋一段时间仍未放行则让出 CPU，避免空转拖慢整体
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int count)
+        : total(count), spinLimit(std::thread::hardware_concurrency() >= static_cast<unsigned>(count) ? 4096 : 0) {}
+
+    void wait() {
+        unsigned gen = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == total) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release); // 最后一个到达者开启下一代
+            return;
+        }
+        for (int spin = 0; generation.load(std::memory_order_acquire) == gen; ++spin) {
+            if (spin < spinLimit) cpuRelax();
+            else std::this_thread::yield();
+        }
+    }
+
+private:
+    const int total;
+    const int spinLimit; // 核数不足时不自旋，直接让出 CPU 给尚未到达的线程
+    alignas(CACHE_LINE_SIZE) std::atomic<int> arrived{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<unsigned> generation{0};
+};
+
+struct LitmusResult {
+    std::string name;
+    std::vector<std::size_t> histogram;      // 下标为结果编码
+    std::vector<std::string> outcomeNames;
+    std::vector<bool> forbidden;
+    std::size_t trials = 0;
+    double seconds = 0;
+
+    std::size_t forbiddenCount() const;
+    void print(std::ostream& os) const;
+};
+
+template<typename Test>
+LitmusResult runLitmus(std::size_t trials, unsigned firstCpu = 0) {
+    constexpr int N = Test::THREADS;
+    Test test;
+    SpinBarrier barrier(N);
+    std::vector<std::size_t> histogram(Test::OUTCOMES, 0);
+
+    auto body = [&](int tid) {
+        pinCurrentThread(firstCpu + tid);
+        std::uint32_t rng = 2463534242u * (tid + 1);
+        for (std::size_t i = 0; i < trials; ++i) {
+            barrier.wait();
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            for (unsigned d = rng & 7; d != 0; --d) cpuRelax();
+            test.run(tid);
+            barrier.wait();
+            // 屏障保证所有线程的写入对 0 号线程可见；0 号线程复位后，下一次屏障才放行其他线程
+            if (tid == 0) {
+                ++histogram[test.outcome()];
+                test.reset();
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < N; ++tid)
+        threads.emplace_back(body, tid);
+    for (auto& t : threads) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    LitmusResult result;
+    result.name = Test::name();
+    result.histogram = std::move(histogram);
+    for (int o = 0; o < Test::OUTCOMES; ++o) {
+        result.outcomeNames.push_back(Test::outcomeName(o));
+        result.forbidden.push_back(Test::forbidden(o));
+    }
+    result.trials = trials;
+    result.seconds = elapsed.count();
+    return result;
+}
+
+const char* memoryOrderName(std::memory_order order);
+
+// 被测变量各占一个缓存行，避免伪共享掩盖（或制造）重排现象
+struct alignas(CACHE_LINE_SIZE) LitmusVar {
+    std::atomic<int> v{0};
+};
+
+template<std::memory_order Store, std::memory_order Load>
+struct StoreBuffering {
+    static constexpr int THREADS = 2;
+    static constexpr int OUTCOMES = 4;
+    LitmusVar x, y;
+    int r0 = 0, r1 = 0;
+
+    void run(int tid) {
+        if (tid == 0) {
+            x.v.store(1, Store);
+            r0 = y.v.load(Load);
+        } else {
+            y.v.store(1, Store);
+            r1 = x.v.load(Load);
+        }
+    }
+    int outcome() const { return r0 | (r1 << 1); }
+    void reset() {
+        x.v.store(0, std::memory_order_relaxed);
+        y.v.store(0, std::memory_order_relaxed);
+        r0 = r1 = 0;
+    }
+    static std::string name() {
+        return std::string("SB  store ") + memoryOrderName(Store) + " / load " + memoryOrderName(Load);
+    }
+    static std::string outcomeName(int o) {
+        return "r0=" + std::to_string(o & 1) + " r1=" + std::to_string((o >> 1) & 1);
+    }
+    static bool forbidden(int o) {
+        return o == 0 && Store == std::memory_order_seq_cst && Load == std::memory_order_seq_cst;
+    }
+};
+
+template<std::memory_order Store, std::memory_order Load>
+struct MessagePassing {
+    static constexpr int THREADS = 2;
+    static constexpr int OUTCOMES = 4;
+    LitmusVar data, flag;
+    int r0 = 0, r1 = 0;
+
+    void run(int tid) {
+        if (tid == 0) {
+            data.v.store(1, std::memory_order_relaxed);
+            flag.v.store(1, Store);
+        } else {
+            r0 = flag.v.load(Load);
+            r1 = data.v.load(std::memory_order_relaxed);
+        }
+    }
+    int outcome() const { return r0 | (r1 << 1); }
+    void reset() {
+        data.v.store(0, std::memory_order_relaxed);
+        flag.v.store(0, std::memory_order_relaxed);
+        r0 = r1 = 0;
+    }
+    static std::string name() {
+        return std::string("MP  flag store ") + memoryOrderName(Store) + " / flag load " + memoryOrderName(Load);
+    }
+    static std::string outcomeName(int o) {
+        return "flag=" + std::to_string(o & 1) + " data=" + std::to_string((o >> 1) & 1);
+    }
+    static bool forbidden(int o) {
+        bool releases = Store == std::memory_order_release || Store == std::memory_order_seq_cst;
+        bool acquires = Load == std::memory_order_acquire || Load == std::memory_order_seq_cst;
+        return o == 1 && releases && acquires; // 看到 flag=1 却读到 data=0
+    }
+};
+
+template<std::memory_order Store, std::memory_order Load>
+struct Iriw {
+    static constexpr int THREADS = 4;
+    static constexpr int OUTCOMES = 16;
+    LitmusVar x, y;
+    int r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+
+    void run(int tid) {
+        switch (tid) {
+        case 0: x.v.store(1, Store); break;
+        case 1: y.v.store(1, Store); break;
+        case 2: r0 = x.v.load(Load); r1 = y.v.load(Load); break;
+        default: r2 = y.v.load(Load); r3 = x.v.load(Load); break;
+        }
+    }
+    int outcome() const { return r0 | (r1 << 1) | (r2 << 2) | (r3 << 3); }
+    void reset() {
+        x.v.store(0, std::memory_order_relaxed);
+        y.v.store(0, std::memory_order_relaxed);
+        r0 = r1 = r2 = r3 = 0;
+    }
+    static std::string name() {
+        return std::string("IRIW store ") + memoryOrderName(Store) + " / load " + memoryOrderName(Load);
+    }
+    static std::string outcomeName(int o) {
+        return "r0=" + std::to_string(o & 1) + " r1=" + std::to_string((o >> 1) & 1) +
+               " r2=" + std::to_string((o >> 2) & 1) + " r3=" + std::to_string((o >> 3) & 1);
+    }
+    static bool forbidden(int o) {
+        return o == 0b0101 && Store == std::memory_order_seq_cst && Load == std::memory_order_seq_cst;
+    }
+};
+
+// 依次运行 SB / MP / IRIW 在不同内存顺序下的测试并打印直方图
+void runLitmusSuite(std::size_t trials = 1000000);
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef __READMOSTLY__H__
+#define __READMOSTLY__H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "cacheLine.h"
+
+/*
+十二、读多写少的共享状态：SeqLock / DistributedRwLock / RcuPtr
+    配置表、路由表每个请求都要读，却很少改。std::mutex 让读者之间也互斥；std::shared_mutex 虽允许并发读，
+但每个读者加锁/解锁都要修改同一个计数器，核心一多这个缓存行就成了瓶颈——读越多越慢。
+    1. SeqLock<T>（顺序锁）：适合很小的、可平凡复制（trivially copyable）的快照
+        写者：序号变为奇数 -> 写数据 -> 序号变为偶数。
+        读者：读序号（必须为偶数）-> 拷贝数据 -> 再读序号，两次相同说明拷贝期间没有写入，否则重试。
+        读者完全不写共享内存，读吞吐随核数线性增长；代价是写者多时读者可能反复重试，且只能整体拷贝。
+        （数据按 8 字节拆成 relaxed 原子字读写，避免 C++ 意义上的数据竞争。）
+    2. DistributedRwLock（分布式读写锁）：读者计数按线程分散到多个缓存行
+        读者只修改自己槽位上的计数；写者先置 writer 标志，再等待所有槽位归零。
+        读锁只碰本线程的缓存行，写锁需要扫描所有槽位，写得更慢——正是读多写少想要的取舍。
+        槽位按线程编号分配（线程不会在加锁、解锁之间换槽位），数量取 2 倍逻辑核数，效果上接近“每核一个计数器”。
+        提供 lock/unlock/lock_shared/unlock_shared，可直接配合 std::unique_lock / std::shared_lock 使用。
+    3. RcuPtr<T> + 基于 epoch 的回收（EBR）：适合较大的对象（整张路由表）
+        读者：进入读临界区（RcuReadGuard），直接读取当前指针，不加锁也不重试。
+        写者：复制一份新对象修改后，用原子 exchange 替换指针；旧对象交给 EpochDomain::retire 延迟释放。
+        回收规则：全局 epoch 只有在所有正在读的线程都已看到当前 epoch 时才能前进；在 epoch r 退休的对象，
+        等全局 epoch 到达 r + 2 时，不可能再有读者持有它，此时才真正 delete。
+*/
+
+inline void readMostlyPause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock only supports trivially copyable types");
+
+public:
+    SeqLock() : SeqLock(T{}) {}
+    explicit SeqLock(const T& init) { writeWords(init); }
+
+    // 写入新快照；多个写者之间通过 writeMutex 串行化
+    void store(const T& value) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::uint64_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);         // 奇数：写入中
+        std::atomic_thread_fence(std::memory_order_release); // 保证“序号变奇数”先于数据写入被看到
+        writeWords(value);
+        seq.store(s + 2, std::memory_order_release);         // 偶数：写入完成
+    }
+
+    // 读取一致的快照；与写入冲突时自动重试
+    T load() const {
+        while (true) {
+            std::uint64_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 & 1) {
+                readMostlyPause();
+                continue;
+            }
+            Words buf;
+            for (std::size_t i = 0; i < WORDS; ++i)
+                buf[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire); // 保证数据读取先于第二次读序号
+            if (seq.load(std::memory_order_relaxed) == s1) {
+                T out;
+                std::memcpy(&out, buf, sizeof(T));
+                return out;
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + 7) / 8;
+    using Words = std::uint64_t[WORDS];
+
+    void writeWords(const T& value) {
+        Words buf = {};
+        std::memcpy(buf, &value, sizeof(T));
+        for (std::size_t i = 0; i < WORDS; ++i)
+            words[i].store(buf[i], std::memory_order_relaxed);
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> seq{0};
+    std::atomic<std::uint64_t> words[WORDS];
+    std::mutex writeMutex;
+};
+
+class DistributedRwLock {
+public:
+    explicit DistributedRwLock(std::size_t slots = 2 * std::max(1u, std::thread::hardware_concurrency()))
+        : slotCount(slots == 0 ? 1 : slots), readers(new Slot[slotCount]) {}
+
+    DistributedRwLock(const DistributedRwLock&) = delete;
+    DistributedRwLock& operator=(const DistributedRwLock&) = delete;
+
+    void lock_shared() {
+        std::atomic<int>& mine = readers[threadSlot() % slotCount].count;
+        while (true) {
+            mine.fetch_add(1, std::memory_order_seq_cst);
+            // 与写者“置标志 -> 检查计数”构成 Dekker 式握手：两者至少有一方能看到对方
+            if (!writer.load(std::memory_order_seq_cst))
+                return;
+            mine.fetch_sub(1, std::memory_order_release);
+            while (writer.load(std::memory_order_relaxed))
+                std::this_thread::yield();
+        }
+    }
+
+    void unlock_shared() {
+        readers[threadSlot() % slotCount].count.fetch_sub(1, std::memory_order_release);
+    }
+
+    void lock() {
+        writeMutex.lock();
+        writer.store(true, std::memory_order_seq_cst);
+        // 计数也必须用 seq_cst 读取：acquire 读不在 seq_cst 全序之内，允许被重排到上面的 store 之前（StoreLoad），
+        // 那样读者和写者可能都看不到对方而同时进入（x86 上 store 恰好是带锁指令才掩盖了这一点）
+        for (std::size_t i = 0; i < slotCount; ++i) {
+            while (readers[i].count.load(std::memory_order_seq_cst) != 0)
+                readMostlyPause();
+        }
+    }
+
+    void unlock() {
+        writer.store(false, std::memory_order_release);
+        writeMutex.unlock();
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<int> count{0};
+    };
+
+    static std::size_t threadSlot() {
+        static std::atomic<std::size_t> nextSlot{0};
+        thread_local std::size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    const std::size_t slotCount;
+    std::unique_ptr<Slot[]> readers;
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> writer{false};
+    std::mutex writeMutex;
+};
+
+// 基于 epoch 的延迟回收域（进程内唯一）
+class EpochDomain {
+public:
+    static EpochDomain& instance();
+
+    // 进入/退出读临界区（可嵌套），一般通过 RcuReadGuard 使用
+    void enter();
+    void exit();
+
+    // 延迟释放 p：保证在此之前进入读临界区的线程都退出之后才调用 deleter(p)
+    void retire(void* p, void (*deleter)(void*));
+
+    // 等待一个完整的宽限期，并释放所有已到期的对象
+    void synchronize();
+
+    ~EpochDomain();
+
+private:
+    struct alignas(CACHE_LINE_SIZE) ThreadRecord {
+        std::atomic<std::uint64_t> state{0}; // 0 表示不在读临界区；否则为 epoch * 2 + 1
+        std::atomic<bool> inUse{false};
+        ThreadRecord* next = nullptr;
+        int nesting = 0;                     // 只由所属线程访问
+    };
+    struct Retired {
+        std::uint64_t epoch;
+        void* ptr;
+        void (*deleter)(void*);
+    };
+    friend struct ThreadRecordHolder;
+
+    EpochDomain() = default;
+    ThreadRecord* acquireRecord();
+    ThreadRecord* currentRecord();
+    bool tryAdvance();
+    void reclaim(std::vector<Retired>& ready);
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> globalEpoch{1};
+    std::atomic<ThreadRecord*> records{nullptr};
+    std::mutex retireMutex;
+    std::vector<Retired> retired;
+};
+
+// RAII 读临界区
+class RcuReadGuard {
+public:
+    RcuReadGuard() { EpochDomain::instance().enter(); }
+    ~RcuReadGuard() { EpochDomain::instance().exit(); }
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard& operator=(const RcuReadGuard&) = delete;
+};
+
+template<typename T>
+class RcuPtr {
+public:
+    explicit RcuPtr(std::unique_ptr<T> init) : ptr(init.release()) {}
+
+    ~RcuPtr() {
+        EpochDomain::instance().synchronize();
+        delete ptr.load(std::memory_order_relaxed);
+    }
+
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    // 必须在 RcuReadGuard 的生命周期内调用，返回的指针在离开临界区前一直有效
+    const T* read() const { return ptr.load(std::memory_order_acquire); }
+
+    // 发布新版本，旧版本延迟释放
+    void update(std::unique_ptr<T> next) {
+        T* old = ptr.exchange(next.release(), std::memory_order_seq_cst); // 先摘除旧版本，再读取 epoch 登记退休
+        EpochDomain::instance().retire(old, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+private:
+    std::atomic<T*> ptr;
+};
+
+// 基准测试：1~64 个读线程在一个写线程持续更新的情况下，各方案每秒读取次数
+void benchReadMostly(int millisPerCase = 300);
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef __SHARDEDCOUNTER__H__
+#define __SHARDEDCOUNTER__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "cacheLine.h"
+
+/*
+十、分片计数器 ShardedCounter
+    taskPlus2/taskMinus2 用 mtx 保护同一个计数器；换成 std::atomic 的 fetch_add 后虽然没有锁了，但所有核心仍在
+争抢同一个缓存行：每次 ++ 都要把该缓存行以独占状态搬到本核心，核心越多，缓存行“弹来弹去”越严重。
+    分片计数器的做法：
+    1. 准备若干个槽位，每个槽位独占一个缓存行（alignas(64)），互不干扰。
+    2. 每个线程第一次使用时分配一个固定的槽位编号（thread_local），之后只写自己的槽位，
+       add() 使用 memory_order_relaxed：计数只要求最终结果正确，不需要和其他内存操作建立先后关系。
+    3. read() 时才把所有槽位加起来（惰性聚合），读操作变慢，但请求计数这类“写多读少”的场景正合适。
+       read() 的结果不是一个精确的瞬时快照（各槽位读取时刻不同），但在所有 add 结束后读取一定精确。
+    线程数超过槽位数时，多个线程会共享一个槽位，fetch_add 仍然保证正确，只是该槽位上会有少量竞争。
+    线程退出时归还编号，新线程复用最小的空闲编号，因此线程频繁创建/退出也不会让存活线程挤进同一个槽位。
+*/
+class ShardedCounter {
+public:
+    // shards 向上取整为 2 的幂，默认取 2 倍逻辑核数
+    explicit ShardedCounter(std::size_t shards = defaultShardCount())
+        : mask(roundUpPow2(shards) - 1), slots(new Slot[mask + 1]) {}
+
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(std::int64_t delta = 1) {
+        slots[threadSlot() & mask].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    std::int64_t read() const {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i <= mask; ++i)
+            sum += slots[i].value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    void reset() {
+        for (std::size_t i = 0; i <= mask; ++i)
+            slots[i].value.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t shardCount() const { return mask + 1; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::int64_t> value{0};
+    };
+
+    static std::size_t defaultShardCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 16 : 2 * static_cast<std::size_t>(n);
+    }
+
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // 线程编号登记表：线程退出时归还编号，新线程优先取最小的空闲编号，
+    // 这样线程反复创建/退出后，同时存活的线程编号仍然连续，不会挤在同一个槽位上而留下空槽位
+    class SlotIds {
+    public:
+        std::size_t acquire() {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (freeIds.empty()) return next++;
+            std::size_t id = freeIds.top();
+            freeIds.pop();
+            return id;
+        }
+
+        void release(std::size_t id) {
+            std::lock_guard<std::mutex> lock(mtx);
+            freeIds.push(id);
+        }
+
+    private:
+        std::mutex mtx;
+        std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t>> freeIds;
+        std::size_t next = 0;
+    };
+
+    static SlotIds& slotIds() {
+        static SlotIds* ids = new SlotIds; // 不析构：其他线程可能在静态对象析构之后才退出
+        return *ids;
+    }
+
+    // 每个线程一个固定编号（线程第一次 add 时分配，退出时归还），使同时存活的相邻线程落在不同槽位
+    static std::size_t threadSlot() {
+        struct Holder {
+            std::size_t id = slotIds().acquire();
+            ~Holder() { slotIds().release(id); }
+        };
+        thread_local Holder holder;
+        return holder.id;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+};
+
+// 基准测试：1~64 个线程各执行 opsPerThread 次 +1，对比 mutex、fetch_add、thread_local 与 ShardedCounter
+void benchShardedCounter(std::size_t opsPerThread = 1000000);
+
+#endif
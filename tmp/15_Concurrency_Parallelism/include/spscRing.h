@@ -0,0 +1,150 @@
+#ifndef __SPSCRING__H__
+#define __SPSCRING__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "cacheLine.h"
+#include "futex.h"
+
+/*
+八、SPSC（单生产者单消费者）无锁环形缓冲
+    很多流水线天然只有一个生产者和一个消费者，此时连 CAS 都不需要：
+    1. tail 只由生产者写，head 只由消费者写，各自用 release 发布、对方用 acquire 读取。
+    2. head、tail 放在不同的缓存行上，避免两个核心互相使对方的缓存行失效（伪共享）。
+    3. 缓存对方索引：生产者保存一份 cachedHead，只有当按 cachedHead 计算“满”时才重新读取真正的 head；
+       消费者同理保存 cachedTail。这样大多数操作只访问本核心独占的缓存行，跨核通信被摊薄到每一圈一次左右。
+    BlockingSpscRing 在此基础上加阻塞：先自旋重试，只有在环空（消费者）或环满（生产者）时才 futex 睡眠，
+对方通过一次 fence + 原子读判断是否需要 futexWake，没有睡眠者时不进入内核。
+*/
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : mask(roundUpPow2(capacity) - 1), buffer(new T[mask + 1]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // 只能由生产者线程调用
+    bool tryPush(T&& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask)
+                return false; // 满
+        }
+        buffer[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由消费者线程调用
+    bool tryPop(T& out) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail)
+                return false; // 空
+        }
+        out = std::move(buffer[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const std::size_t mask;
+    const std::unique_ptr<T[]> buffer;
+
+    // 生产者独占的缓存行：自己的写索引 + 消费者索引的本地副本
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead = 0;
+    // 消费者独占的缓存行
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail = 0;
+    // 填充到缓存行末尾，避免与紧随其后的对象共享缓存行
+    char padding[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+};
+
+template<typename T>
+class BlockingSpscRing {
+public:
+    explicit BlockingSpscRing(std::size_t capacity) : ring(capacity) {}
+
+    // 生产者：环满时阻塞
+    void push(T value) {
+        for (int spin = 0; !ring.tryPush(std::move(value)); ++spin) {
+            if (spin < SPIN_LIMIT) continue;
+            producerSleeping.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // 声明要睡眠之后再检查一次，与消费者的“pop 后检查标志”构成 Dekker 式握手，不会丢失唤醒
+            if (ring.tryPush(std::move(value))) {
+                producerSleeping.store(0, std::memory_order_relaxed);
+                break;
+            }
+            futexWait(&producerSleeping, 1);
+            spin = 0;
+        }
+        wake(consumerSleeping);
+    }
+
+    // 消费者：环空时阻塞
+    void pop(T& out) {
+        for (int spin = 0; !ring.tryPop(out); ++spin) {
+            if (spin < SPIN_LIMIT) continue;
+            consumerSleeping.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring.tryPop(out)) {
+                consumerSleeping.store(0, std::memory_order_relaxed);
+                break;
+            }
+            futexWait(&consumerSleeping, 1);
+            spin = 0;
+        }
+        wake(producerSleeping);
+    }
+
+    bool tryPush(T&& value) {
+        if (!ring.tryPush(std::move(value))) return false;
+        wake(consumerSleeping);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        if (!ring.tryPop(out)) return false;
+        wake(producerSleeping);
+        return true;
+    }
+
+private:
+    static constexpr int SPIN_LIMIT = 128;
+
+    static void wake(std::atomic<std::uint32_t>& sleeping) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) != 0 && sleeping.exchange(0, std::memory_order_relaxed) != 0)
+            futexWake(&sleeping, 1);
+    }
+
+    SpscRing<T> ring;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> producerSleeping{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> consumerSleeping{0};
+};
+
+// 基准测试：单个生产者/消费者对传递 totalOps 个元素，对比 SpscRing、BlockingSpscRing 与互斥锁 + 条件变量队列
+void benchSpscRing(std::size_t totalOps = 100000000);
+
+#endif
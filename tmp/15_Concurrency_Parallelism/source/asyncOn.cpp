@@ -0,0 +1,97 @@
+#include "asyncOn.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+Executor::Executor(std::size_t threads) {
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back(&Executor::worker, this);
+}
+
+Executor::~Executor() {
+    shutdown();
+}
+
+void Executor::shutdown() {
+    tasks.close(); // 关闭后工作线程取空剩余任务再退出
+    for (auto& w : workers) {
+        if (w.joinable()) w.join();
+    }
+}
+
+void Executor::worker() {
+    std::unique_ptr<TaskBase> batch[16];
+    std::size_t k;
+    while ((k = tasks.recvN(batch, 16)) > 0) {
+        for (std::size_t i = 0; i < k; ++i) {
+            try {
+                batch[i]->run(); // packaged_task 会把异常存入 future；直接 execute 的任务则可能抛出
+            } catch (...) {
+                // 异常逃出线程函数会调用 std::terminate，整个进程退出；这里丢弃，工作线程继续取任务
+            }
+            batch[i].reset();
+        }
+    }
+}
+
+Executor& defaultExecutor() {
+    static Executor executor;
+    return executor;
+}
+
+namespace {
+
+int twice(int x) {
+    if (x < 0) throw std::runtime_error("negative input");
+    return x * 2;
+}
+
+// 同时在途的 future 数上限。libstdc++ 的 std::async future 在 get() 之前一直持有已结束但未 join 的线程，
+// 其栈映射不会释放；一次攒上 10 万个会耗尽 vm.max_map_count，线程创建失败而 terminate。两列使用同一窗口以保持公平
+constexpr std::size_t WINDOW = 1000;
+
+template<typename Launch>
+double runCalls(std::size_t calls, Launch launch, bool& ok) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<int>> futures;
+    futures.reserve(std::min(calls, WINDOW));
+    long long sum = 0;
+    for (std::size_t begin = 0; begin < calls; begin += WINDOW) {
+        std::size_t end = std::min(calls, begin + WINDOW);
+        for (std::size_t i = begin; i < end; ++i)
+            futures.push_back(launch(static_cast<int>(i)));
+        for (auto& f : futures) sum += f.get();
+        futures.clear();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    long long n = static_cast<long long>(calls);
+    ok = ok && sum == n * (n - 1);
+    return elapsed.count();
+}
+
+} // namespace
+
+void benchAsyncOn(std::size_t calls) {
+    bool ok = true;
+    double stdAsync = runCalls(calls, [](int i) { return std::async(std::launch::async, twice, i); }, ok);
+    double pooled = runCalls(calls, [](int i) { return asyncOn(twice, i); }, ok);
+    std::cout << calls << " 次异步调用:" << std::endl;
+    std::cout << "std::async(launch::async): " << stdAsync * 1000 << " ms, " << stdAsync / calls * 1e6 << " us/次" << std::endl;
+    std::cout << "asyncOn(defaultExecutor): " << pooled * 1000 << " ms, " << pooled / calls * 1e6 << " us/次"
+              << (ok ? "" : "  (结果错误!)") << std::endl;
+
+    // 异常传播：与 std::async 相同，在 get() 时重新抛出
+    bool thrown = false;
+    try {
+        asyncOn(twice, -1).get();
+    } catch (const std::runtime_error& e) {
+        thrown = true;
+        std::cout << "异常传播正常: " << e.what() << std::endl;
+    }
+    if (!thrown) std::cout << "asyncOn 的异常没有在 get() 时抛出 (结果错误!)" << std::endl;
+
+    // 直接 execute 的任务抛出异常：工作线程不能因此退出，之后的任务照常执行
+    defaultExecutor().execute([]() { throw std::runtime_error("fire and forget"); });
+    bool alive = asyncOn(twice, 21).get() == 42;
+    std::cout << "execute 任务抛出异常后执行器" << (alive ? "仍正常工作" : "返回了错误结果 (结果错误!)") << std::endl;
+}
@@ -0,0 +1,76 @@
+#include "channel.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// 单次测试：producers 个生产者共发送 totalItems 个整数，consumers 个消费者接收并求和校验
+// batch > 1 时使用 sendN/recvN 批量收发
+double runChannelOnce(std::size_t capacity, int producers, int consumers, std::size_t totalItems, std::size_t batch) {
+    Channel<std::uint64_t> ch(capacity);
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> checksum{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumerThreads;
+    for (int c = 0; c < consumers; ++c) {
+        consumerThreads.emplace_back([&]() {
+            std::vector<std::uint64_t> buf(batch);
+            std::uint64_t sum = 0, count = 0;
+            std::size_t k;
+            while ((k = ch.recvN(buf.begin(), batch)) > 0) {
+                for (std::size_t i = 0; i < k; ++i) sum += buf[i];
+                count += k;
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+            received.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+
+    std::vector<std::thread> producerThreads;
+    for (int p = 0; p < producers; ++p) {
+        producerThreads.emplace_back([&, p]() {
+            std::size_t begin = totalItems * p / producers;
+            std::size_t end = totalItems * (p + 1) / producers;
+            std::vector<std::uint64_t> buf(batch);
+            for (std::size_t i = begin; i < end;) {
+                if (batch == 1) {
+                    ch.send(i++);
+                    continue;
+                }
+                std::size_t n = 0;
+                for (; n < batch && i < end; ++n, ++i) buf[n] = i;
+                ch.sendN(buf.begin(), n);
+            }
+        });
+    }
+
+    for (auto& t : producerThreads) t.join();
+    ch.close(); // 所有生产者结束后关闭，消费者取空剩余数据后自然退出
+    for (auto& t : consumerThreads) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t n = totalItems;
+    if (received.load() != n || checksum.load() != n * (n - 1) / 2)
+        std::cerr << "校验失败: received = " << received.load() << ", expected = " << n << std::endl;
+    return totalItems / elapsed.count();
+}
+
+} // namespace
+
+void benchChannel(std::size_t totalItems) {
+    const int threadCounts[] = {1, 2, 4, 8, 16};
+    std::cout << "Channel<T> 基准测试, 元素个数 = " << totalItems << std::endl;
+    for (std::size_t capacity : {std::size_t(1024), Channel<std::uint64_t>::UNBOUNDED}) {
+        for (std::size_t batch : {std::size_t(1), std::size_t(64)}) {
+            for (int n : threadCounts) {
+                double rate = runChannelOnce(capacity, n, n, totalItems, batch);
+                std::cout << (capacity == Channel<std::uint64_t>::UNBOUNDED ? "[无界]" : "[有界 1024]")
+                          << " batch = " << batch
+                          << ", 生产者/消费者 = " << n << "/" << n
+                          << ", 吞吐量 = " << rate / 1e6 << " M items/sec" << std::endl;
+            }
+        }
+    }
+}
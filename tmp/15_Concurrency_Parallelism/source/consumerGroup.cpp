@@ -0,0 +1,114 @@
+#include "consumerGroup.h"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <queue>
+#include <string>
+
+namespace {
+
+const int PRODUCERS = 2;
+const int CONSUMERS = 4;
+
+// 对照组：main.cpp 中的 std::queue + 互斥锁 + 条件变量，加上 finished 标志使消费者能够退出
+double runMutexPipeline(std::size_t totalItems, std::uint64_t& sum) {
+    std::mutex mtx;
+    std::condition_variable notEmpty, notFull;
+    std::queue<std::uint64_t> q;
+    bool finished = false;
+    const std::size_t maxSize = 1024;
+    std::atomic<std::uint64_t> total{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < CONSUMERS; ++c) {
+        consumers.emplace_back([&]() {
+            std::uint64_t s = 0;
+            while (true) {
+                std::unique_lock<std::mutex> lock(mtx);
+                notEmpty.wait(lock, [&]() { return !q.empty() || finished; });
+                if (q.empty()) break; // finished 且已取空
+                s += q.front();
+                q.pop();
+                lock.unlock();
+                notFull.notify_one();
+            }
+            total.fetch_add(s, std::memory_order_relaxed);
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            for (std::size_t i = totalItems * p / PRODUCERS; i < totalItems * (p + 1) / PRODUCERS; ++i) {
+                std::unique_lock<std::mutex> lock(mtx);
+                notFull.wait(lock, [&]() { return q.size() < maxSize; });
+                q.push(i);
+                lock.unlock();
+                notEmpty.notify_one();
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = true;
+    }
+    notEmpty.notify_all();
+    for (auto& t : consumers) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    sum = total.load();
+    return elapsed.count();
+}
+
+double runChannelPipeline(std::size_t totalItems, std::size_t batchSize, std::uint64_t& sum) {
+    Channel<std::uint64_t> ch(1024);
+    std::atomic<std::uint64_t> total{0};
+
+    auto start = std::chrono::steady_clock::now();
+    ConsumerGroup<std::uint64_t> group(ch, CONSUMERS, [&](std::uint64_t* items, std::size_t n) {
+        std::uint64_t s = 0;
+        for (std::size_t i = 0; i < n; ++i) s += items[i];
+        total.fetch_add(s, std::memory_order_relaxed);
+    }, batchSize);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            std::vector<std::uint64_t> buf(batchSize);
+            std::size_t i = totalItems * p / PRODUCERS, end = totalItems * (p + 1) / PRODUCERS;
+            while (i < end) {
+                std::size_t n = 0;
+                for (; n < batchSize && i < end; ++n, ++i) buf[n] = i;
+                ch.sendN(buf.begin(), n);
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    ch.close();   // 毒丸：消费者取空后退出
+    group.join(); // 确定性结束：返回时所有元素都已处理
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    sum = total.load();
+    return elapsed.count();
+}
+
+void report(const char* name, double seconds, std::uint64_t sum, std::size_t totalItems) {
+    std::uint64_t n = totalItems;
+    std::cout << name << ": 端到端耗时 " << seconds * 1000 << " ms, "
+              << totalItems / seconds / 1e6 << " M items/sec"
+              << (sum == n * (n - 1) / 2 ? "" : "  (校验失败!)") << std::endl;
+}
+
+} // namespace
+
+void benchPipeline(std::size_t totalItems) {
+    std::cout << "流水线基准测试, 元素个数 = " << totalItems
+              << ", 生产者/消费者 = " << PRODUCERS << "/" << CONSUMERS << std::endl;
+    std::uint64_t sum = 0;
+    double t = runMutexPipeline(totalItems, sum);
+    report("[mutex + condition_variable + finished]", t, sum, totalItems);
+    for (std::size_t batch : {1, 16, 256}) {
+        t = runChannelPipeline(totalItems, batch, sum);
+        std::string name = "[Channel + ConsumerGroup, batch = " + std::to_string(batch) + "]";
+        report(name.c_str(), t, sum, totalItems);
+    }
+}
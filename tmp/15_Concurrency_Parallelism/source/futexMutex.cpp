@@ -0,0 +1,104 @@
+#include "futexMutex.h"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 短临界区：与 data_queue.push 相当的几条指令。返回每次 lock+unlock 的平均耗时（纳秒）
+template<typename Mutex>
+double lockHoldBench(int threads, std::size_t iterations, bool& ok) {
+    Mutex m;
+    std::vector<int> ring(64);
+    std::size_t counter = 0;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                std::lock_guard<Mutex> lock(m);
+                ring[counter & 63] = static_cast<int>(i);
+                ++counter;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    ok = ok && counter == threads * iterations;
+    return elapsed.count() / (threads * iterations);
+}
+
+// 对照组：mutex + condition_variable 实现的二值信号
+class CvSignal {
+public:
+    void post() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            ready = true;
+        }
+        cv.notify_one();
+    }
+    void wait() {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return ready; });
+        ready = false;
+    }
+private:
+    std::mutex m;
+    std::condition_variable cv;
+    bool ready = false;
+};
+
+// 乒乓测试：A post -> B wait 返回 -> B post -> A wait 返回，往返时间的一半即单次交接延迟（微秒）
+template<typename Signal>
+double handoffBench(std::size_t rounds) {
+    Signal ping, pong;
+    std::thread peer([&]() {
+        for (std::size_t i = 0; i < rounds; ++i) {
+            ping.wait();
+            pong.post();
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+        ping.post();
+        pong.wait();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    peer.join();
+    return elapsed.count() / rounds / 2;
+}
+
+// FutexEvent 是手动复位事件，乒乓时由等待方复位
+class EventSignal {
+public:
+    void post() { ev.set(); }
+    void wait() {
+        ev.wait();
+        ev.reset();
+    }
+private:
+    FutexEvent ev;
+};
+
+} // namespace
+
+void benchFutexPrimitives(std::size_t iterations) {
+    std::cout << "短临界区加锁耗时（ns / 次 lock+unlock）, 每线程 " << iterations << " 次" << std::endl;
+    for (int threads : {1, 2, 4, 8, 16}) {
+        bool ok = true;
+        double stdNs = lockHoldBench<std::mutex>(threads, iterations, ok);
+        double futexNs = lockHoldBench<SpinFutexMutex>(threads, iterations, ok);
+        std::cout << "线程数 = " << threads << "  std::mutex: " << stdNs << "  SpinFutexMutex: " << futexNs
+                  << (ok ? "" : "  (计数错误!)") << std::endl;
+    }
+
+    std::size_t rounds = iterations / 10;
+    std::cout << "两线程交接延迟（us / 次）, " << rounds << " 次往返" << std::endl;
+    std::cout << "mutex + condition_variable: " << handoffBench<CvSignal>(rounds) << std::endl;
+    std::cout << "FutexSemaphore:             " << handoffBench<FutexSemaphore>(rounds) << std::endl;
+    std::cout << "FutexEvent:                 " << handoffBench<EventSignal>(rounds) << std::endl;
+}
@@ -0,0 +1,108 @@
+#include "lightFuture.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 单线程：创建 promise -> 取 future -> 设置值 -> get，返回每轮平均耗时（纳秒）
+template<typename Round>
+double singleThreadBench(std::size_t iterations, Round round, bool& ok) {
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+        sum += round(static_cast<int>(i & 1023));
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    long long expected = 0;
+    for (std::size_t i = 0; i < iterations; ++i) expected += static_cast<int>(i & 1023);
+    ok = ok && sum == expected;
+    return elapsed.count() / iterations;
+}
+
+// 跨线程：主线程预先建好 promise/future 对，另一线程依次设置值，主线程依次 get，返回每对平均耗时（纳秒）
+template<typename Promise, typename Future, typename MakePair, typename SetValue>
+double crossThreadBench(std::size_t count, MakePair makePair, SetValue setValue, bool& ok) {
+    std::vector<Promise> promises;
+    std::vector<Future> futures;
+    promises.reserve(count);
+    futures.reserve(count);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i) makePair(promises, futures);
+    std::thread producer([&]() {
+        for (std::size_t i = 0; i < count; ++i) setValue(promises[i], static_cast<int>(i & 1023));
+    });
+    long long sum = 0;
+    for (std::size_t i = 0; i < count; ++i) sum += futures[i].get();
+    producer.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    long long expected = 0;
+    for (std::size_t i = 0; i < count; ++i) expected += static_cast<int>(i & 1023);
+    ok = ok && sum == expected;
+    return elapsed.count() / count;
+}
+
+} // namespace
+
+void benchLightFuture(std::size_t iterations) {
+    bool ok = true;
+    std::cout << "单线程 设置值 -> 取值（ns / 次）, " << iterations << " 次" << std::endl;
+    double stdNs = singleThreadBench(iterations, [](int v) {
+        std::promise<int> p;
+        std::future<int> f = p.get_future();
+        p.set_value(v);
+        return f.get();
+    }, ok);
+    double pooledNs = singleThreadBench(iterations, [](int v) {
+        LightPromise<int> p;
+        LightFuture<int> f = p.getFuture();
+        p.setValue(v);
+        return f.get();
+    }, ok);
+    FutureSlot<int> slot;
+    double slotNs = singleThreadBench(iterations, [&](int v) {
+        int r;
+        {
+            LightPromise<int> p(slot);
+            LightFuture<int> f = p.getFuture();
+            p.setValue(v);
+            r = f.get();
+        }
+        slot.reset();
+        return r;
+    }, ok);
+    std::cout << "std::promise/future:        " << stdNs << std::endl;
+    std::cout << "LightPromise（对象池槽位）: " << pooledNs << "  加速比: " << stdNs / pooledNs << std::endl;
+    std::cout << "LightPromise（调用者槽位）: " << slotNs << "  加速比: " << stdNs / slotNs << std::endl;
+
+    std::size_t pairs = iterations / 10;
+    std::cout << "跨线程 设置值 -> 取值（ns / 对）, " << pairs << " 对" << std::endl;
+    double stdCross = crossThreadBench<std::promise<int>, std::future<int>>(pairs,
+        [](auto& ps, auto& fs) { ps.emplace_back(); fs.push_back(ps.back().get_future()); },
+        [](std::promise<int>& p, int v) { p.set_value(v); }, ok);
+    double lightCross = crossThreadBench<LightPromise<int>, LightFuture<int>>(pairs,
+        [](auto& ps, auto& fs) { ps.emplace_back(); fs.push_back(ps.back().getFuture()); },
+        [](LightPromise<int>& p, int v) { p.setValue(v); }, ok);
+    std::cout << "std::promise/future:        " << stdCross << std::endl;
+    std::cout << "LightPromise（对象池槽位）: " << lightCross << "  加速比: " << stdCross / lightCross << std::endl;
+
+    // 超时与异常语义与 std::future 一致
+    LightPromise<int> slow;
+    LightFuture<int> slowFut = slow.getFuture();
+    std::thread worker([p = std::move(slow)]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        p.setException(std::make_exception_ptr(std::runtime_error("division can not be zero!")));
+    });
+    if (slowFut.wait_for(std::chrono::milliseconds(1)) == std::future_status::timeout)
+        std::cout << "wait_for(1ms): Time out!" << std::endl;
+    try {
+        slowFut.get();
+        ok = false;
+    }
+    catch (std::runtime_error& e) {
+        std::cout << "get() 重新抛出: " << e.what() << std::endl;
+    }
+    worker.join();
+    if (!ok) std::cout << "(校验失败!)" << std::endl;
+}
@@ -0,0 +1,53 @@
+#include "litmus.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+const char* memoryOrderName(std::memory_order order) {
+    switch (order) {
+    case std::memory_order_relaxed: return "relaxed";
+    case std::memory_order_consume: return "consume";
+    case std::memory_order_acquire: return "acquire";
+    case std::memory_order_release: return "release";
+    case std::memory_order_acq_rel: return "acq_rel";
+    default:                        return "seq_cst";
+    }
+}
+
+std::size_t LitmusResult::forbiddenCount() const {
+    std::size_t n = 0;
+    for (std::size_t o = 0; o < histogram.size(); ++o) {
+        if (forbidden[o]) n += histogram[o];
+    }
+    return n;
+}
+
+void LitmusResult::print(std::ostream& os) const {
+    // 先格式化到局部流，不改动调用方流上的 fixed / precision / 对齐设置
+    std::ostringstream out;
+    out << "[" << name << "]  " << trials << " 次试验, "
+        << std::fixed << std::setprecision(2) << trials / seconds / 1e6 << " M trials/sec\n";
+    for (std::size_t o = 0; o < histogram.size(); ++o) {
+        if (histogram[o] == 0 && !forbidden[o]) continue;
+        out << "    " << std::left << std::setw(28) << outcomeNames[o] << std::right << std::setw(12) << histogram[o]
+            << "  (" << std::setprecision(4) << 100.0 * histogram[o] / trials << "%)";
+        if (forbidden[o]) out << (histogram[o] ? "  <- 禁止结果出现了!" : "  (禁止结果)");
+        out << '\n';
+    }
+    os << out.str() << std::flush;
+}
+
+void runLitmusSuite(std::size_t trials) {
+    using std::memory_order_relaxed;
+    using std::memory_order_acquire;
+    using std::memory_order_release;
+    using std::memory_order_seq_cst;
+
+    runLitmus<StoreBuffering<memory_order_relaxed, memory_order_relaxed>>(trials).print(std::cout);
+    runLitmus<StoreBuffering<memory_order_release, memory_order_acquire>>(trials).print(std::cout);
+    runLitmus<StoreBuffering<memory_order_seq_cst, memory_order_seq_cst>>(trials).print(std::cout);
+    runLitmus<MessagePassing<memory_order_relaxed, memory_order_relaxed>>(trials).print(std::cout);
+    runLitmus<MessagePassing<memory_order_release, memory_order_acquire>>(trials).print(std::cout);
+    runLitmus<Iriw<memory_order_release, memory_order_acquire>>(trials).print(std::cout);
+    runLitmus<Iriw<memory_order_seq_cst, memory_order_seq_cst>>(trials).print(std::cout);
+}
@@ -90,6 +90,8 @@ void taskMinus2(){
         num2--;
     }
 }
+//高频计数器：include/shardedCounter.h 中的 ShardedCounter（每线程独占缓存行的槽位，读取时再求和）
+#include "shardedCounter.h"
 void testMutex(){
     std::thread t1(taskPlus), t2(taskMinus);
     t1.join();
@@ -101,6 +103,8 @@ void testMutex(){
     t4.join();
     std::cout << "num2 = " << num2 << std::endl;
 }
+//读多写少（配置表、路由表）：include/readMostly.h 中的 SeqLock、DistributedRwLock、RcuPtr（epoch 回收）
+#include "readMostly.h"
 /*
 四、条件变量
     1. 概念
@@ -169,6 +173,7 @@ std::mutex mtx_pc;
 std::condition_variable cv_producer, cv_consumer;
 std::queue<int> data_queue;
 const int MAX_SIZE = 10;
+bool producer_done = false; //生产者全部结束的标志（受 mtx_pc 保护），消费者据此在取空队列后退出
 
 void producer(int id){
     for (int i = 0; i < 200; i++){
@@ -184,7 +189,8 @@ void producer(int id){
 void consumer(int id){
     while (true) {
         std::unique_lock<std::mutex> lock(mtx_pc);
-        cv_consumer.wait(lock, []{ return !data_queue.empty(); }); // 等待队列非空
+        cv_consumer.wait(lock, []{ return !data_queue.empty() || producer_done; }); // 等待队列非空或生产结束
+        if (data_queue.empty()) break; // 生产已结束且队列已取空，消费者正常退出
         int data = data_queue.front();
         data_queue.pop();
         std::cout << "Consumer " << id << " consumed " << data << std::endl;
@@ -198,9 +204,23 @@ void testProducerConsumer(){
     std::thread c1(consumer, 1);
     std::thread c2(consumer, 2);
     p1.join();
-    c1.detach();
-    c2.detach();
+    {
+        std::lock_guard<std::mutex> lock(mtx_pc);
+        producer_done = true;
+    }
+    cv_consumer.notify_all(); // 唤醒所有消费者检查结束条件
+    //不要 detach：detach 后消费者永远在死循环里，进程退出时它可能还在运行，也无法确认数据已全部处理
+    c1.join();
+    c2.join();
 }
+//高吞吐版本：include/channel.h 中的 Channel<T>（无锁环形队列 + 关闭语义 + 批量收发）
+#include "channel.h"
+//严格单生产者单消费者时：include/spscRing.h 中的 SpscRing / BlockingSpscRing（无 CAS，仅在空/满时 futex 睡眠）
+#include "spscRing.h"
+//批处理流水线：include/consumerGroup.h 中的 ConsumerGroup（close 即毒丸、可 join、批量取出）
+#include "consumerGroup.h"
+//临界区很短时（如 data_queue.push），锁本身的睡眠/唤醒开销占主导：include/futexMutex.h 中的 SpinFutexMutex、FutexSemaphore、FutexEvent
+#include "futexMutex.h"
 /*
 五、期物 std::future
     1. 背景
@@ -319,6 +339,8 @@ void testPackageTask(){
         std::cerr << "unexpected error!" << std::endl;
     }
 }
+//以上每次调用都会新建线程；复用常驻线程的 asyncOn(executor, fn, args...) 见 include/asyncOn.h
+#include "asyncOn.h"
 //4.超时处理
 void testOuttime(){
     std::packaged_task<int()> task([](){
@@ -335,6 +357,8 @@ void testOuttime(){
         std::cout << "Time out!\n";
     }
 }
+//std::promise/future 每对都在堆上分配共享状态；无堆分配、基于 futex 的 LightPromise/LightFuture 见 include/lightFuture.h
+#include "lightFuture.h"
 /*
 六、内存顺序与原子操作
     1. 概念补充
@@ -473,6 +497,8 @@ void testAcuRel(){
         }
     }
 }
+//以上三个测试每次迭代都创建线程，很难观察到重排；常驻绑核线程 + 自旋屏障的 litmus 工具见 include/litmus.h
+#include "litmus.h"
 
 
 int main(){
@@ -486,6 +512,15 @@ int main(){
     //testReorder();
     //testRelaxed();
     testAcuRel();
+    //benchChannel();
+    //benchSpscRing();
+    //benchPipeline();
+    //benchShardedCounter();
+    //runLitmusSuite();
+    //benchReadMostly();
+    //benchFutexPrimitives();
+    //benchAsyncOn();
+    //benchLightFuture();
     return 0;
 }
 
@@ -0,0 +1,203 @@
+#include "readMostly.h"
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+
+// 线程退出时归还自己的 ThreadRecord，供之后新建的线程复用
+struct ThreadRecordHolder {
+    EpochDomain::ThreadRecord* record = nullptr;
+    ~ThreadRecordHolder() {
+        if (record) record->inUse.store(false, std::memory_order_release);
+    }
+};
+
+EpochDomain& EpochDomain::instance() {
+    static EpochDomain domain;
+    return domain;
+}
+
+EpochDomain::~EpochDomain() {
+    // 进程退出时已没有读者，剩余对象全部释放
+    for (auto& r : retired) r.deleter(r.ptr);
+    ThreadRecord* r = records.load(std::memory_order_acquire);
+    while (r) {
+        ThreadRecord* next = r->next;
+        delete r;
+        r = next;
+    }
+}
+
+EpochDomain::ThreadRecord* EpochDomain::acquireRecord() {
+    // 先尝试复用已退出线程留下的记录
+    for (ThreadRecord* r = records.load(std::memory_order_acquire); r; r = r->next) {
+        bool expected = false;
+        if (!r->inUse.load(std::memory_order_relaxed) &&
+            r->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return r;
+    }
+    ThreadRecord* r = new ThreadRecord;
+    r->inUse.store(true, std::memory_order_relaxed);
+    ThreadRecord* head = records.load(std::memory_order_relaxed);
+    do {
+        r->next = head;
+    } while (!records.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+    return r;
+}
+
+EpochDomain::ThreadRecord* EpochDomain::currentRecord() {
+    thread_local ThreadRecordHolder holder;
+    if (!holder.record) holder.record = acquireRecord();
+    return holder.record;
+}
+
+void EpochDomain::enter() {
+    ThreadRecord* r = currentRecord();
+    if (r->nesting++ > 0) return;
+    std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+    while (true) {
+        r->state.store(e * 2 + 1, std::memory_order_seq_cst);
+        // 发布之后再确认一次：若期间 epoch 已前进，写者可能没看到我们，需用新 epoch 重新登记
+        std::uint64_t now = globalEpoch.load(std::memory_order_seq_cst);
+        if (now == e) break;
+        e = now;
+    }
+}
+
+void EpochDomain::exit() {
+    ThreadRecord* r = currentRecord();
+    if (--r->nesting == 0)
+        r->state.store(0, std::memory_order_release);
+}
+
+bool EpochDomain::tryAdvance() {
+    std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+    for (ThreadRecord* r = records.load(std::memory_order_acquire); r; r = r->next) {
+        std::uint64_t s = r->state.load(std::memory_order_seq_cst);
+        if (s != 0 && (s >> 1) != e)
+            return false; // 还有读者停留在更早的 epoch
+    }
+    globalEpoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    return true;
+}
+
+void EpochDomain::reclaim(std::vector<Retired>& ready) {
+    std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+    std::size_t keep = 0;
+    for (auto& r : retired) {
+        if (r.epoch + 2 <= e) ready.push_back(r);
+        else retired[keep++] = r;
+    }
+    retired.resize(keep);
+}
+
+void EpochDomain::retire(void* p, void (*deleter)(void*)) {
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lock(retireMutex);
+        retired.push_back({globalEpoch.load(std::memory_order_seq_cst), p, deleter});
+        tryAdvance();
+        reclaim(ready);
+    }
+    for (auto& r : ready) r.deleter(r.ptr); // 在锁外执行析构，避免 deleter 耗时阻塞其他写者
+}
+
+void EpochDomain::synchronize() {
+    // 注意：不能在读临界区内调用，否则本线程会阻止 epoch 前进而永远等待
+    std::uint64_t target = globalEpoch.load(std::memory_order_seq_cst) + 2;
+    while (globalEpoch.load(std::memory_order_seq_cst) < target) {
+        if (!tryAdvance()) std::this_thread::yield();
+    }
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lock(retireMutex);
+        reclaim(ready);
+    }
+    for (auto& r : ready) r.deleter(r.ptr);
+}
+
+namespace {
+
+// 被读取的“配置”：各字段由 version 推导，读者据此检查是否读到了撕裂（不一致）的快照
+struct Config {
+    std::uint64_t version;
+    std::uint64_t a, b, c;
+};
+
+Config makeConfig(std::uint64_t v) { return Config{v, v * 3, v * 5, v * 7}; }
+
+bool consistent(const Config& c) {
+    return c.a == c.version * 3 && c.b == c.version * 5 && c.c == c.version * 7;
+}
+
+// readers 个读线程 + 1 个写线程（每 1ms 更新一次）运行 millis 毫秒，返回每秒读取次数（百万）
+template<typename Read, typename Write>
+double runReadMostly(int readers, int millis, Read read, Write write, bool& ok) {
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> totalReads{0};
+    std::atomic<bool> torn{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back([&]() {
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int k = 0; k < 64; ++k) {
+                    if (!consistent(read())) torn.store(true, std::memory_order_relaxed);
+                }
+                n += 64;
+            }
+            totalReads.fetch_add(n, std::memory_order_relaxed);
+        });
+    }
+    std::thread writer([&]() {
+        for (std::uint64_t v = 1; !stop.load(std::memory_order_relaxed); ++v) {
+            write(makeConfig(v));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+    stop.store(true);
+    for (auto& t : threads) t.join();
+    writer.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    ok = ok && !torn.load();
+    return totalReads.load() / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+void benchReadMostly(int millisPerCase) {
+    std::cout << "读多写少基准测试（1 个写线程每 1ms 更新一次，单位: M reads/sec）" << std::endl;
+    for (int readers : {1, 2, 4, 8, 16, 32, 64}) {
+        bool ok = true;
+
+        std::shared_mutex sm;
+        Config smConfig = makeConfig(0);
+        double smRate = runReadMostly(readers, millisPerCase,
+            [&]() { std::shared_lock<std::shared_mutex> lock(sm); return smConfig; },
+            [&](const Config& c) { std::unique_lock<std::shared_mutex> lock(sm); smConfig = c; }, ok);
+
+        DistributedRwLock drw;
+        Config drwConfig = makeConfig(0);
+        double drwRate = runReadMostly(readers, millisPerCase,
+            [&]() { std::shared_lock<DistributedRwLock> lock(drw); return drwConfig; },
+            [&](const Config& c) { std::unique_lock<DistributedRwLock> lock(drw); drwConfig = c; }, ok);
+
+        SeqLock<Config> seq(makeConfig(0));
+        double seqRate = runReadMostly(readers, millisPerCase,
+            [&]() { return seq.load(); },
+            [&](const Config& c) { seq.store(c); }, ok);
+
+        RcuPtr<Config> rcu(std::make_unique<Config>(makeConfig(0)));
+        double rcuRate = runReadMostly(readers, millisPerCase,
+            [&]() { RcuReadGuard guard; return *rcu.read(); },
+            [&](const Config& c) { rcu.update(std::make_unique<Config>(c)); }, ok);
+
+        std::cout << "读线程 = " << readers
+                  << "  shared_mutex: " << smRate
+                  << "  DistributedRwLock: " << drwRate
+                  << "  SeqLock: " << seqRate
+                  << "  RcuPtr: " << rcuRate
+                  << (ok ? "" : "  (读到不一致快照!)") << std::endl;
+    }
+}
@@ -0,0 +1,82 @@
+#include "shardedCounter.h"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// threads 个线程同时执行 body(opsPerThread)，返回总吞吐量（M ops/sec）
+template<typename Body>
+double runThreads(int threads, std::size_t opsPerThread, Body body) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(opsPerThread);
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : workers) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * opsPerThread / elapsed.count() / 1e6;
+}
+
+// thread_local 方案：每个线程累加到自己的局部变量，线程退出前才合并到全局计数器。
+// 写入最快，但在线程结束前无法读到准确值，不适合需要随时读取的请求计数。
+std::atomic<std::int64_t> tlsTotal{0};
+thread_local std::int64_t tlsCounter = 0;
+
+} // namespace
+
+void benchShardedCounter(std::size_t opsPerThread) {
+    std::cout << "计数器基准测试, 每线程 +1 次数 = " << opsPerThread << " (单位: M ops/sec)" << std::endl;
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        const std::int64_t expected = static_cast<std::int64_t>(threads) * opsPerThread;
+        bool ok = true;
+
+        std::mutex m;
+        std::int64_t plain = 0;
+        double mutexRate = runThreads(threads, opsPerThread, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                std::lock_guard<std::mutex> lock(m);
+                ++plain;
+            }
+        });
+        ok = ok && plain == expected;
+
+        std::atomic<std::int64_t> shared{0};
+        double atomicRate = runThreads(threads, opsPerThread, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                shared.fetch_add(1, std::memory_order_relaxed);
+        });
+        ok = ok && shared.load() == expected;
+
+        tlsTotal.store(0);
+        double tlsRate = runThreads(threads, opsPerThread, [&](std::size_t n) {
+            tlsCounter = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                ++tlsCounter;
+                asm volatile("" : "+m"(tlsCounter)); // 阻止编译器把循环合并成一次加法，每次 +1 都真正读写内存
+            }
+            tlsTotal.fetch_add(tlsCounter, std::memory_order_relaxed);
+        });
+        ok = ok && tlsTotal.load() == expected;
+
+        ShardedCounter sharded;
+        double shardedRate = runThreads(threads, opsPerThread, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                sharded.add();
+        });
+        ok = ok && sharded.read() == expected;
+
+        std::cout << "线程数 = " << threads
+                  << "  mutex: " << mutexRate
+                  << "  fetch_add: " << atomicRate
+                  << "  thread_local: " << tlsRate
+                  << "  ShardedCounter: " << shardedRate
+                  << (ok ? "" : "  (校验失败!)") << std::endl;
+    }
+}
@@ -0,0 +1,89 @@
+#include "spscRing.h"
+#include "cpuAffinity.h"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace {
+
+// 对照组：与 main.cpp 中 producer/consumer 相同的 std::queue + mutex + 两个条件变量
+class MutexQueue {
+public:
+    explicit MutexQueue(std::size_t capacity) : capacity(capacity) {}
+    void push(std::uint64_t v) {
+        std::unique_lock<std::mutex> lock(mtx);
+        notFull.wait(lock, [&]() { return q.size() < capacity; });
+        q.push(v);
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+    void pop(std::uint64_t& out) {
+        std::unique_lock<std::mutex> lock(mtx);
+        notEmpty.wait(lock, [&]() { return !q.empty(); });
+        out = q.front();
+        q.pop();
+        lock.unlock();
+        notFull.notify_one();
+    }
+private:
+    std::size_t capacity;
+    std::mutex mtx;
+    std::condition_variable notFull, notEmpty;
+    std::queue<std::uint64_t> q;
+};
+
+template<typename Push, typename Pop>
+void runSpsc(const char* name, std::size_t totalOps, Push push, Pop pop) {
+    std::uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        pinCurrentThread(1);
+        std::uint64_t v, s = 0;
+        for (std::size_t i = 0; i < totalOps; ++i) {
+            pop(v);
+            s += v;
+        }
+        sum = s;
+    });
+    std::thread producer([&]() {
+        pinCurrentThread(0);
+        for (std::size_t i = 0; i < totalOps; ++i)
+            push(i);
+    });
+    producer.join();
+    consumer.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t n = totalOps;
+    std::cout << name << ": " << totalOps / elapsed.count() / 1e6 << " M ops/sec"
+              << (sum == n * (n - 1) / 2 ? "" : "  (校验失败!)") << std::endl;
+}
+
+} // namespace
+
+void benchSpscRing(std::size_t totalOps) {
+    const std::size_t capacity = 4096;
+    std::cout << "SPSC 基准测试, 元素个数 = " << totalOps << ", 容量 = " << capacity << std::endl;
+    {
+        SpscRing<std::uint64_t> ring(capacity);
+        runSpsc("[SpscRing 自旋]", totalOps,
+                [&](std::uint64_t v) { while (!ring.tryPush(std::move(v))) {} },
+                [&](std::uint64_t& out) { while (!ring.tryPop(out)) {} });
+    }
+    {
+        BlockingSpscRing<std::uint64_t> ring(capacity);
+        runSpsc("[BlockingSpscRing]", totalOps,
+                [&](std::uint64_t v) { ring.push(v); },
+                [&](std::uint64_t& out) { ring.pop(out); });
+    }
+    {
+        // 互斥锁版本每个元素都有加锁 + notify，只跑 1/100 的元素数以控制时间，结果同样按 ops/sec 换算
+        MutexQueue q(capacity);
+        runSpsc("[mutex + condition_variable]", totalOps / 100,
+                [&](std::uint64_t v) { q.push(v); },
+                [&](std::uint64_t& out) { q.pop(out); });
+    }
+}
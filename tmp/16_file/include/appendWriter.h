@@ -0,0 +1,110 @@
+#ifndef __APPENDWRITER__H__
+#define __APPENDWRITER__H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+追加写日志：AppendWriter
+    testlink 中的 out << ... << std::endl：std::endl 每行都会 flush，即每行一次 write 系统调用；
+日志一秒几十万行时，几乎所有时间都花在系统调用上。
+    做法：
+        1. 写入先复制到大块缓冲区（默认 4 块 × 1 MB，按 4 KB 对齐），一块写满就封存，换下一块继续写；
+        2. 封存的缓冲区用一次 writev 全部写出（文件以 O_APPEND 打开），系统调用次数降到每 MB 一次左右；
+        3. 按大小（缓冲区写满）或按时间（距上次写出超过 flushInterval）触发写出，保证日志不会在内存里滞留太久；
+           不开后台线程时，时间阈值在下一次 append 时检查；
+        4. sync()：写出并 fdatasync，提供持久化保证。多个线程同时 sync 时做组提交（group commit）：
+           正在 fdatasync 的线程结束后，等待者中的一个把这期间所有线程追加的数据一并写出、一并 fdatasync，
+           其余线程发现自己的数据已被覆盖就直接返回，fdatasync 次数远少于 sync 调用次数；
+        5. backgroundFlush 为 true 时由后台线程负责写出，append 只做内存复制；
+           所有缓冲区都已封存而后台线程还没写完时，append 等待（背压），内存占用有上限。
+    线程安全：append / flush / sync 可以被多个线程同时调用，同一次 append 的内容保证连续。
+    写出失败时抛出 std::system_error（后台线程的失败在下一次 append / flush / sync 时抛出）。
+*/
+
+struct AppendOptions {
+    std::size_t bufferSize = std::size_t(1) << 20;
+    std::size_t bufferCount = 4;
+    std::chrono::milliseconds flushInterval{100}; // 为 0 时只按大小写出
+    bool backgroundFlush = false;
+};
+
+struct AppendStats {
+    std::uint64_t bytes = 0;  // 追加的总字节数
+    std::uint64_t writes = 0; // writev 调用次数
+    std::uint64_t syncs = 0;  // fdatasync 调用次数
+};
+
+class AppendWriter {
+public:
+    explicit AppendWriter(const std::string& path, const AppendOptions& options = AppendOptions());
+    ~AppendWriter(); // 写出剩余数据并关闭（不做 fdatasync）
+    AppendWriter(const AppendWriter&) = delete;
+    AppendWriter& operator=(const AppendWriter&) = delete;
+
+    void append(std::string_view data);
+    void appendLine(std::string_view line); // line + '\n'，两部分保证连续
+    // 写出缓冲区中的所有数据（进入页缓存，不保证落盘）
+    void flush();
+    // 写出并 fdatasync，返回时此前所有 append 的数据都已落盘
+    void sync();
+
+    AppendStats stats() const;
+
+private:
+    struct Buffer {
+        char* data;
+        std::size_t used;
+    };
+
+    // 把各部分连续地追加，然后按大小/时间阈值决定是否写出
+    void appendParts(std::unique_lock<std::mutex>& lock, std::initializer_list<std::string_view> parts);
+    void copyIn(std::unique_lock<std::mutex>& lock, std::string_view data);
+    void sealCurrent();
+    // 调用时持有 mtx；把封存的缓冲区（includePartial 时连同当前未满的缓冲区）用 writev 写出，返回已写出数据覆盖的字节数
+    std::uint64_t writeOut(std::unique_lock<std::mutex>& lock, bool includePartial);
+    static std::uint64_t coarseNowNs();
+    bool intervalElapsed() const;
+    void flusherLoop();
+    void rethrowFailure();
+
+    AppendOptions options;
+    int fd = -1;
+
+    mutable std::mutex mtx; // 保护以下缓冲区状态
+    std::condition_variable cv;
+    std::vector<char*> freeBuffers;
+    std::vector<Buffer> sealed; // 已写满、等待写出，按追加顺序
+    Buffer current{nullptr, 0};
+    std::uint64_t appended = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t lastFlushNs = 0;
+    bool writing = false;    // 有线程正在 writev；同一时刻只有一个，保证写入顺序
+    bool appendBusy = false; // 某次 append 正在进行（可能中途释放了锁等待缓冲区），其他 append 需等它完成
+    bool lockReleased = false;
+    bool stopping = false;
+    std::exception_ptr failure;
+
+    mutable std::mutex syncMtx; // 组提交
+    std::condition_variable syncCv;
+    bool syncing = false;
+    std::uint64_t synced = 0; // 已经 fdatasync 过的字节数
+    std::uint64_t syncs = 0;
+
+    std::vector<char*> allBuffers;
+    std::thread flusher;
+};
+
+// 基准测试：ofstream + endl、ofstream + '\n' 与 AppendWriter（同步写出 / 后台写出 / 多线程组提交）每秒写入的行数
+void benchAppendWriter(const std::string& path, std::size_t lines = 1000000);
+
+#endif
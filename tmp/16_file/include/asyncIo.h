@@ -0,0 +1,90 @@
+#ifndef __ASYNCIO__H__
+#define __ASYNCIO__H__
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+/*
+异步文件 I/O：AsyncIo
+    ifstream/ofstream 与 pread/pwrite 都是阻塞调用：一个线程同一时刻只能有一个读请求在途，
+想让 SSD 同时处理 64 个请求就得开 64 个线程，线程切换和栈内存的开销随之而来。
+    io_uring（Linux 5.1+）：用户态与内核共享两个环形队列，提交队列（SQ）放请求、完成队列（CQ）放结果。
+        1. 批量提交：read()/write() 只是在 SQ 中填一个条目，submit() 一次 io_uring_enter 系统调用提交所有积攒的请求；
+        2. 注册缓冲区（registerBuffers）：内核预先固定这些内存页，之后用 READ_FIXED/WRITE_FIXED，省掉每次请求的页固定与释放；
+        3. 固定文件（registerFiles）：内核预先持有文件引用，请求中用下标代替 fd，省掉每次请求的 fd 查找与引用计数；
+        4. 完成以回调或 std::future 交出：回调/future 在调用 poll()/wait() 的线程中执行/就绪；
+        5. 除读写外还支持 statx（IORING_OP_STATX），批量取元数据时同样一次提交多个请求。
+    不依赖 liburing，直接用 io_uring_setup / io_uring_enter / io_uring_register 系统调用与 mmap 的环形队列。
+    后备实现：内核不支持、被禁用（io_uring_disabled、容器的 seccomp）时自动改用线程池 + epoll：
+        工作线程执行阻塞的 pread/pwrite，完成结果放入完成队列并写 eventfd，poll()/wait() 用 epoll 等待该 eventfd。
+        （普通文件本身不能加入 epoll，它总是“就绪”的，所以真正的等待由工作线程承担。）接口与语义与 io_uring 完全相同。
+    注意：
+        1. 一个 AsyncIo 只能由一个线程提交和收割（与 liburing 的约定相同），需要多线程时每个线程各用一个；
+        2. 在途请求数达到 queueDepth 时，read()/write() 会先提交并收割至少一个完成，保证完成队列不会溢出；
+        3. 缓冲区在请求完成前必须保持有效；结果为读写的字节数，失败时为 -errno。
+        4. 回调抛出的异常从 poll()/wait() 传出；同一批完成的其余回调照常执行，多个回调抛出时只传出第一个。
+*/
+
+enum class IoBackend { IoUring, ThreadPool };
+
+// 文件的引用：普通 fd，或 registerFiles 返回的固定文件下标
+struct IoFile {
+    int value;
+    bool fixed;
+    static IoFile fd(int fd) { return {fd, false}; }
+    static IoFile registered(int index) { return {index, true}; }
+};
+
+using IoCallback = std::function<void(int result)>;
+
+class AsyncIo {
+public:
+    class Engine;
+
+    // preferred 为 IoUring 但不可用时退回 ThreadPool；fallbackThreads 为 0 时线程数与 queueDepth 相同
+    explicit AsyncIo(unsigned queueDepth = 256, IoBackend preferred = IoBackend::IoUring, unsigned fallbackThreads = 0);
+    ~AsyncIo(); // 等待所有在途请求完成，期间回调抛出的异常被丢弃
+    AsyncIo(const AsyncIo&) = delete;
+    AsyncIo& operator=(const AsyncIo&) = delete;
+
+    IoBackend backend() const;
+    unsigned queueDepth() const;
+
+    // 只能注册一次，在发起请求之前调用；之后用下标 0..n-1 引用（IoFile::registered、bufferIndex）
+    void registerFiles(const std::vector<int>& fds);
+    void registerBuffers(const std::vector<iovec>& buffers);
+
+    // bufferIndex >= 0 时 buf 必须位于该注册缓冲区内部（使用 READ_FIXED/WRITE_FIXED）
+    void read(IoFile file, void* buf, std::size_t len, off_t offset, IoCallback callback, int bufferIndex = -1);
+    void write(IoFile file, const void* buf, std::size_t len, off_t offset, IoCallback callback, int bufferIndex = -1);
+    std::future<int> read(IoFile file, void* buf, std::size_t len, off_t offset, int bufferIndex = -1);
+    std::future<int> write(IoFile file, const void* buf, std::size_t len, off_t offset, int bufferIndex = -1);
+    // 参数与 statx(2) 相同，结果为 0 或 -errno；path 与 out 在完成前必须保持有效
+    void statx(int dirfd, const char* path, int flags, unsigned mask, struct statx* out, IoCallback callback);
+
+    // 提交所有积攒的请求，返回提交的个数
+    unsigned submit();
+    // 提交并收割已完成的请求（执行回调），至少等到 minComplete 个完成，返回收割的个数
+    unsigned poll(unsigned minComplete = 0);
+    // 等待所有在途请求完成
+    void wait();
+    // 已发起但尚未收割的请求数（含未提交的）
+    unsigned inFlight() const;
+
+private:
+    std::unique_ptr<Engine> engine;
+};
+
+const char* ioBackendName(IoBackend backend);
+
+// 基准测试：4KB 随机读（O_DIRECT，不支持时退回页缓存），队列深度 1~256 下 io_uring、线程池后备与“每线程一个 pread”的 IOPS
+void benchAsyncIo(const std::string& path, std::size_t fileBytes = std::size_t(1) << 30);
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef __DIRECTFILE__H__
+#define __DIRECTFILE__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+class AsyncIo;
+
+/*
+直接 I/O：DirectReader / DirectWriter
+    std::ios::binary 的文件流和普通 read/write 都经过页缓存：对几 TB 的数据顺序扫描一遍，每一页只用一次，
+却把页缓存里其他进程的热数据全部挤出去（缓存颠簸），内核还要多做一次内核缓冲区到用户缓冲区的复制。
+    O_DIRECT 让 DMA 直接在磁盘和用户缓冲区之间传输，不进入页缓存，代价是对齐要求：
+缓冲区地址、文件偏移、传输长度都必须是设备逻辑块大小的整数倍。
+    做法：
+        1. 对齐：用 statx(STATX_DIOALIGN)（6.1+）查询文件实际要求的对齐，至少按 4 KB 对齐；缓冲区来自 AlignedBufferPool；
+        2. 双缓冲预读：DirectReader 用 AsyncIo（io_uring，不支持时为线程池）始终保持后面 buffers - 1 块的读请求在途，
+           调用方处理当前块时磁盘已经在读下一块；DirectWriter 写满一块就异步提交，接着填下一块；
+        3. 尾部：读取时最后一块按对齐的长度发起、内核返回实际剩余的字节数；
+           写入时最后不满一块的数据补 0 到对齐长度再写，最后 ftruncate 回真实大小；
+        4. 后备：文件系统拒绝 O_DIRECT（open 返回 EINVAL，或 statx 报告不支持）时改用普通 I/O，接口不变，
+           并用 posix_fadvise(DONTNEED)（写入时先 sync_file_range 写回）及时丢弃处理过的页，尽量不占页缓存；
+           页缓存以大页块（large folio，可达数 MB）为单位，DONTNEED 只丢弃完全落在范围内的块，
+           所以每次丢弃的范围从上次的终点往回多退一段，否则跨越边界的块永远不会被丢弃（实测会残留八成以上）。
+    注意：
+        1. 只支持从头到尾的顺序读写；DirectReader::next 返回的块只在下一次调用 next 之前有效；
+        2. DirectWriter 不保证落盘：O_DIRECT 只绕过页缓存，设备缓存和文件元数据仍需要 sync()（fdatasync）；
+        3. 失败时抛出 std::system_error；析构函数中的错误被忽略，需要知道结果时先调用 close()。
+*/
+
+// 固定数量、按 alignment 对齐的缓冲区，大小向上取整到 alignment 的倍数；单线程使用
+class AlignedBufferPool {
+public:
+    AlignedBufferPool(std::size_t bufferSize, std::size_t count, std::size_t alignment = 4096);
+    ~AlignedBufferPool();
+    AlignedBufferPool(const AlignedBufferPool&) = delete;
+    AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+    char* acquire(); // 没有空闲缓冲区时返回 nullptr
+    void release(char* buffer);
+
+    std::size_t bufferSize() const { return size; }
+    std::size_t alignment() const { return align; }
+    std::size_t available() const { return freeBuffers.size(); }
+
+private:
+    std::size_t size;
+    std::size_t align;
+    std::vector<char*> buffers;
+    std::vector<char*> freeBuffers;
+};
+
+struct DirectOptions {
+    std::size_t bufferSize = std::size_t(1) << 20;
+    std::size_t buffers = 2;   // 2 为双缓冲；更多则预读/写出得更深
+    bool allowFallback = true; // 为 false 时不支持 O_DIRECT 就抛出异常
+};
+
+class DirectReader {
+public:
+    explicit DirectReader(const std::string& path, const DirectOptions& options = DirectOptions());
+    ~DirectReader();
+    DirectReader(const DirectReader&) = delete;
+    DirectReader& operator=(const DirectReader&) = delete;
+
+    // 下一块数据（除最后一块外都是 bufferSize 字节），读完时返回 false
+    bool next(std::span<const std::byte>& block);
+
+    bool direct() const { return isDirect; }
+    std::size_t alignment() const { return pool->alignment(); }
+    std::uint64_t size() const { return fileSize; }
+
+private:
+    struct Pending {
+        char* buffer;
+        std::uint64_t offset;
+        int result;
+        bool done;
+    };
+
+    void issue();
+
+    int fd = -1;
+    bool isDirect = false;
+    std::uint64_t fileSize = 0;
+    std::uint64_t nextOffset = 0; // 下一个要发起的读请求的偏移
+    std::uint64_t dropped = 0;    // 后备模式：已从页缓存丢弃到的偏移
+    std::unique_ptr<AlignedBufferPool> pool;
+    std::unique_ptr<AsyncIo> io;
+    std::deque<std::shared_ptr<Pending>> pending; // 按偏移排列的在途读请求
+    std::shared_ptr<Pending> current;             // 调用方正在使用的块
+};
+
+class DirectWriter {
+public:
+    // 创建或截断 path
+    explicit DirectWriter(const std::string& path, const DirectOptions& options = DirectOptions());
+    ~DirectWriter(); // 调用 close()，忽略错误
+    DirectWriter(const DirectWriter&) = delete;
+    DirectWriter& operator=(const DirectWriter&) = delete;
+
+    void write(const void* data, std::size_t len);
+    // 写出剩余数据（尾部补齐后截断回真实大小）并等待所有写请求完成，之后不能再 write
+    void close();
+    // close 并 fdatasync
+    void sync();
+
+    bool direct() const { return isDirect; }
+    std::size_t alignment() const { return pool->alignment(); }
+    std::uint64_t bytes() const { return written; }
+
+private:
+    void submitCurrent(std::size_t len);
+    void rethrowFailure();
+
+    int fd = -1;
+    bool isDirect = false;
+    bool closed = false;
+    std::uint64_t written = 0;    // write 接收的总字节数
+    std::uint64_t submitted = 0;  // 已提交写请求的文件偏移
+    std::uint64_t dropped = 0;    // 后备模式：已从页缓存丢弃到的偏移
+    std::unique_ptr<AlignedBufferPool> pool;
+    std::unique_ptr<AsyncIo> io;
+    char* current = nullptr;
+    std::size_t used = 0;
+    std::exception_ptr failure;
+};
+
+// 基准测试：生成 bytes 大小的文件，对比 ofstream / DirectWriter 写入与 read / DirectReader 读取的吞吐，以及之后该文件在页缓存中的驻留量
+void benchDirectIo(const std::string& path, std::size_t bytes = std::size_t(1) << 30);
+
+#endif
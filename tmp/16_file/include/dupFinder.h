@@ -0,0 +1,72 @@
+#ifndef __DUPFINDER__H__
+#define __DUPFINDER__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "dirWalker.h"
+
+/*
+重复文件查找：findDuplicates
+    在 recursiveList 的基础上找重复文件，最直接的写法是把每个文件整个读出来算哈希，几百 GB 的数据全部要读一遍。
+绝大多数文件其实在前几步就能排除。逐级筛选，每一级只处理上一级还有“同伴”的文件：
+        1. 大小：bulkStatTree（parallelWalk + statx）取得所有普通文件的大小、设备号和 inode，大小唯一的文件不可能重复；
+           同一 (设备, inode) 的多个路径是硬链接，只保留一个，它们不占额外空间，也不算重复；
+        2. 部分哈希：只读文件开头和末尾各 4 KB（pread），内容不同的文件大多在这里分开；不超过 8 KB 的文件这一步就是完整内容；
+        3. 完整哈希：按 1 MB 分块 pread（顺序访问提示），流式计算 64 位哈希（XXH64）；
+           不用 mmap：扫描期间被截短的文件，访问映射中越过新末尾的页会触发 SIGBUS，pread 只是提前读到文件末尾；
+        4. 逐字节校验（verify，默认开启）：64 位哈希仍有极小的碰撞概率，删除文件前用 memcmp 与组内第一个文件确认内容完全相同。
+    流水线：每个文件的每一步都是一个任务，放进同一个任务队列由多个线程执行；
+某个大小组（或部分哈希组）的最后一个任务完成时，完成它的线程立即把组内文件按结果重新分组，为仍有同伴的文件生成下一步的任务。
+不同的组处于不同的阶段，一个线程在读小文件的头尾时，另一个线程可以在对大文件算完整哈希，磁盘和 CPU 都不会空等。
+    注意：
+        1. 扫描期间被修改或删除的文件：打不开、读取出错或大小与遍历时不同的计入 errors 并从组中去掉；
+           校验时作为基准的文件出错，则换组内下一个文件作为基准重新校验；大小不变的内容修改仍可能导致误判，删除前请再次确认；
+        2. 空文件默认不参与（minSize = 1），它们内容都相同但不占空间；
+        3. 不跟随符号链接。
+*/
+
+// XXH64（xxHash 的 64 位版本）
+std::uint64_t xxh64(const void* data, std::size_t len, std::uint64_t seed = 0);
+
+struct DuplicateOptions {
+    std::size_t threads = std::thread::hardware_concurrency();
+    std::uint64_t minSize = 1;        // 小于该大小的文件不参与
+    std::size_t partialBytes = 4096;  // 部分哈希读取开头和末尾各多少字节
+    bool verify = true;               // 完整哈希相同后再逐字节比较
+    WalkOptions walk;                 // 遍历选项（filter 可用来跳过 .git 等子树）
+};
+
+struct DuplicateGroup {
+    std::uint64_t size = 0;
+    std::uint64_t hash = 0;
+    std::vector<std::string> paths; // 按路径排序，至少两个
+};
+
+struct DuplicateReport {
+    std::vector<DuplicateGroup> groups; // 按可回收空间从大到小排序
+    std::uint64_t files = 0;            // 参与比较的普通文件数（硬链接只算一次）
+    std::uint64_t hardLinks = 0;        // 因与已有路径指向同一 inode 而跳过的路径数
+    std::uint64_t partialHashed = 0;    // 大小筛选后剩下、计算了部分哈希的文件数
+    std::uint64_t fullHashed = 0;       // 部分哈希筛选后剩下、计算了完整哈希的文件数
+    std::uint64_t bytesRead = 0;        // 读取的总字节数（部分哈希 + 完整哈希 + 校验）
+    std::uint64_t errors = 0;
+    double seconds = 0;
+
+    std::uint64_t duplicateFiles() const;  // 每组除第一个以外的文件数
+    std::uint64_t reclaimableBytes() const; // 每组只保留一个时可以回收的空间
+};
+
+// root 无法打开时抛出 std::system_error，其余的错误计入 errors
+DuplicateReport findDuplicates(const std::string& root, const DuplicateOptions& options = DuplicateOptions());
+
+// 输出各阶段的统计与每个重复组，最多列出 maxGroups 组
+void printDuplicateReport(const DuplicateReport& report, std::ostream& out, std::size_t maxGroups = 20);
+
+// 基准测试：在 dir 下生成带有各类“差一点相同”的文件的目录树，对比“每个文件整个读出来算哈希”与 findDuplicates
+void benchDuplicateFinder(const std::string& dir, std::size_t files = 2000);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __ENTRYTYPE__H__
+#define __ENTRYTYPE__H__
+
+// 目录项的类型：目录遍历、元数据缓存、批量 stat 共用；与 st_mode / d_type 的转换见 fileUtil.h
+enum class EntryType { File, Directory, Symlink, Other };
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __FILECOPY__H__
+#define __FILECOPY__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/*
+大文件复制：copyFile
+    fs::copy 在部分 libstdc++ 版本中就是单线程的 read/write 循环：数据经过 内核 -> 用户缓冲区 -> 内核 两次复制，
+稀疏文件的空洞也被当作 0 读出再写入，几百 GB 的文件要复制很久，目标文件还会膨胀成实际大小。
+    依次尝试以下方式，前一种不支持时自动降级到下一种：
+        1. Reflink（ioctl FICLONE）：btrfs、XFS（reflink=1）、bcachefs 等写时复制文件系统上只复制元数据，瞬间完成、不占额外空间；
+        2. copy_file_range：数据在内核内部复制，不经过用户态；同一文件系统上还可能由文件系统优化（NFS 服务端复制、XFS/btrfs 自动 reflink）；
+        3. sendfile：同样在内核内复制，支持的内核与文件系统组合更多（copy_file_range 在 5.3 之前不能跨文件系统）；
+        4. pread/pwrite：用户态复制，每个线程一块按 4 KB 对齐的大缓冲区。
+    2~4 都按块（默认 64 MB）切分，由多个线程并行复制；对网络文件系统和多队列 SSD，多个在途请求能明显提高吞吐。
+    稀疏文件：先把目标 ftruncate 到源文件大小（全部是空洞），再用 lseek(SEEK_DATA/SEEK_HOLE) 找出源文件的数据段，
+只复制数据段，空洞保持为空洞。文件系统不支持 SEEK_DATA 时整个文件视为一个数据段。
+    失败时抛出 std::system_error，目标文件可能只写了一部分。
+*/
+
+enum class CopyMethod { Reflink, CopyFileRange, Sendfile, ReadWrite };
+
+struct CopyOptions {
+    CopyMethod firstMethod = CopyMethod::Reflink; // 从这种方式开始尝试，用于强制使用较慢的方式做对比
+    std::size_t threads = std::thread::hardware_concurrency();
+    std::size_t chunkSize = std::size_t(64) << 20;
+    std::size_t bufferSize = std::size_t(4) << 20; // 仅 pread/pwrite 使用
+    bool preserveSparse = true;
+};
+
+struct CopyResult {
+    CopyMethod method;           // 实际使用的方式（多种方式混用时为最慢的一种）
+    std::uint64_t bytes = 0;     // 源文件大小
+    std::uint64_t dataBytes = 0; // 实际复制的数据段字节数（不含空洞）
+    double seconds = 0;
+    double throughput() const { return seconds > 0 ? bytes / seconds / 1e9 : 0; } // GB/s，按文件大小计算
+};
+
+const char* copyMethodName(CopyMethod method);
+
+// 复制 src 到 dst（存在则覆盖），权限位与源文件相同；两者是同一个文件（含硬链接、符号链接）时抛出 std::system_error（file_exists），不修改文件
+CopyResult copyFile(const std::string& src, const std::string& dst, const CopyOptions& options = CopyOptions());
+
+// 基准测试：在 dir 下生成 bytes 大小、一半为空洞的稀疏文件，对比 fs::copy 与各种复制方式的吞吐和目标文件的实际占用
+void benchFileCopy(const std::string& dir, std::size_t bytes = std::size_t(1) << 30);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef __FILEUTIL__H__
+#define __FILEUTIL__H__
+
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <system_error>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "entryType.h"
+
+/*
+本章各模块共用的小工具（只有头文件）
+    1. FdGuard：离开作用域时关闭文件描述符，fd < 0 时什么都不做；
+    2. typeFromMode / typeFromDirent：把 st_mode（statx 的 stx_mode）或 getdents64 的 d_type 转成 EntryType；
+    3. 基准测试：secondsOf 计时一次调用，checkMark 在结果校验不通过时返回 "(校验失败!)" 标记；
+    4. throwErrno：把 errno（或给定的错误码）包装成 std::system_error 抛出，what 写出错的操作和路径。
+*/
+
+struct FdGuard {
+    int fd;
+    ~FdGuard() {
+        if (fd >= 0) close(fd);
+    }
+};
+
+inline EntryType typeFromMode(unsigned mode) {
+    if (S_ISREG(mode)) return EntryType::File;
+    if (S_ISDIR(mode)) return EntryType::Directory;
+    if (S_ISLNK(mode)) return EntryType::Symlink;
+    return EntryType::Other;
+}
+
+// DT_UNKNOWN（部分文件系统不填 d_type）也返回 Other，需要时调用方再 fstatat
+inline EntryType typeFromDirent(unsigned char type) {
+    switch (type) {
+        case DT_REG: return EntryType::File;
+        case DT_DIR: return EntryType::Directory;
+        case DT_LNK: return EntryType::Symlink;
+        default: return EntryType::Other;
+    }
+}
+
+// f() 的耗时，单位秒
+template<typename F>
+double secondsOf(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+inline const char* checkMark(bool ok) { return ok ? "" : "  (校验失败!)"; }
+
+[[noreturn]] inline void throwErrno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] inline void throwErrno(int error, const std::string& what) {
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef __LINEREADER__H__
+#define __LINEREADER__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+零复制按行读取：LineSplitter / Lines / LineReader
+    std::getline(in, line) 每一行都要：从流缓冲区逐字符查找换行、复制到 std::string、行比 string 的容量长时重新分配。
+日志文件动辄几个 GB、几千万行，这些复制和逐字符比较就成了瓶颈。
+    做法：
+        1. 换行查找用 SIMD：每次取 64 字节，与 '\n' 比较得到 64 位掩码（AVX2 两次 32 字节比较，不支持时 SSE2 四次 16 字节），
+           掩码中每个 1 就是一个换行的位置，用 ctz 逐个取出。短行很多时，一次比较可以切出好几行，
+           比每行调用一次 memchr 更省；
+        2. 行以 std::string_view 返回，直接指向映射的文件（MappedFile::view()）或读缓冲区，不复制、不分配；
+        3. LineSplitter 切分一段连续内存；Lines 是它的 range 包装，可以直接用于 range-for；
+        4. LineReader 是流式模式：用 read 把文件分块读入缓冲区，缓冲区末尾不完整的行移到缓冲区开头，
+           与下一块拼接后再交出；单行比缓冲区还长时缓冲区自动加倍。适合不能或不想 mmap 的场景（管道、标准输入、网络文件系统）。
+    与 getline 的语义一致：行不含 '\n'；最后一行没有换行符时照样返回；文件以 '\n' 结尾时不会多出一个空行；'\r' 保留在行内。
+    LineReader 返回的 string_view 只在下一次调用 next 之前有效。
+*/
+
+// 返回 p[0..63] 中等于 '\n' 的字节的位掩码（第 i 位对应 p[i]），按 CPU 支持选择 AVX2 或 SSE2
+std::uint64_t newlineMask64(const char* p);
+const char* newlineMaskIsa();
+
+class LineSplitter {
+public:
+    LineSplitter() = default;
+    // 调用方已知 text 的前 skip 个字节中没有换行时（LineReader 拼接上一块的残行），从该处开始扫描
+    explicit LineSplitter(std::string_view text, std::size_t skip = 0) : text(text), blockStart(skip / 64 * 64) {
+        mask = blockStart < text.size() ? blockMask(blockStart) : 0;
+    }
+
+    // 下一个以 '\n' 结尾的行；没有更多换行时返回 false，剩余的部分由 rest() 取得
+    bool nextTerminated(std::string_view& line) {
+        while (mask == 0) {
+            blockStart += 64;
+            if (blockStart >= text.size()) return false;
+            mask = blockMask(blockStart);
+        }
+        std::size_t newline = blockStart + static_cast<std::size_t>(__builtin_ctzll(mask));
+        mask &= mask - 1;
+        line = text.substr(pos, newline - pos);
+        pos = newline + 1;
+        return true;
+    }
+
+    // 与 getline 相同：最后一行没有换行符也返回
+    bool next(std::string_view& line) {
+        if (nextTerminated(line)) return true;
+        if (pos >= text.size()) return false;
+        line = text.substr(pos);
+        pos = text.size();
+        return true;
+    }
+
+    // 最后一个换行之后、尚未返回的部分
+    std::string_view rest() const { return text.substr(pos); }
+
+private:
+    std::uint64_t blockMask(std::size_t start) const {
+        if (text.size() - start >= 64) return newlineMask64(text.data() + start);
+        char padded[64] = {}; // 不足 64 字节的尾部补 0 后再比较，不会越界读取
+        text.copy(padded, text.size() - start, start);
+        return newlineMask64(padded);
+    }
+
+    std::string_view text;
+    std::size_t pos = 0;        // 当前行的起点
+    std::size_t blockStart = 0; // mask 对应的 64 字节块的起点
+    std::uint64_t mask = 0;     // 该块中尚未返回的换行位置
+};
+
+// for (std::string_view line : Lines(mapped.view())) ...
+class Lines {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        explicit iterator(std::string_view text) : splitter(text), atEnd(false) { ++*this; }
+        reference operator*() const { return line; }
+        pointer operator->() const { return &line; }
+        iterator& operator++() {
+            if (!splitter.next(line)) atEnd = true;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return atEnd && other.atEnd; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        LineSplitter splitter;
+        std::string_view line;
+        bool atEnd = true;
+    };
+
+    explicit Lines(std::string_view text) : text(text) {}
+    iterator begin() const { return iterator(text); }
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view text;
+};
+
+class LineReader {
+public:
+    // 打开失败时抛出 std::system_error
+    explicit LineReader(const std::string& path, std::size_t bufferSize = std::size_t(1) << 20);
+    // 从已打开的描述符读取（例如 0 为标准输入），不负责关闭
+    explicit LineReader(int fd, std::size_t bufferSize = std::size_t(1) << 20);
+    ~LineReader();
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    bool next(std::string_view& line);
+
+private:
+    bool refill();
+
+    int fd = -1;
+    bool ownsFd = false;
+    bool eof = false;
+    std::vector<char> buffer;
+    std::size_t filled = 0;
+    LineSplitter splitter;
+};
+
+// 基准测试：生成 bytes 大小的日志文件，对比 getline、MappedFile + memchr、MappedFile + Lines、LineReader 的切行速度
+void benchLineSplit(const std::string& path, std::size_t bytes = std::size_t(512) << 20);
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __MAPPEDFILE__H__
+#define __MAPPEDFILE__H__
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+/*
+内存映射文件：MappedFile
+    ifstream::read / getline 每个字节都要经过两次复制：内核页缓存 -> 流缓冲区 -> 用户的 string/数组，
+外加每次 underflow 的 read 系统调用。mmap 把文件的页缓存直接映射到进程地址空间，读取就是普通的内存访问，
+没有复制，也没有逐块的系统调用；只在首次访问某页时发生一次缺页。
+    访问提示（madvise）：
+        Normal：内核默认的预读；
+        Sequential：顺序扫描，加大预读窗口，已读过的页可以尽早回收；
+        Random：随机查找，关闭预读，避免每次缺页都读入用不到的相邻页；
+        WillNeed：立即在后台把整个范围读入页缓存，之后的访问不再等待磁盘。
+    1. ReadOnly 映射为 PROT_READ + MAP_SHARED；ReadWrite 映射为 PROT_READ|PROT_WRITE + MAP_SHARED，修改直接写回文件，
+       可用 sync() 强制刷盘；ReadWrite 可以指定 size，文件会先被扩展（或截断）到该长度，文件不存在时创建。
+       映射建立后文件描述符即关闭，映射本身保持对文件的引用。
+    2. bytes() 返回 std::span<const std::byte>，view() 返回 std::string_view，生命周期与 MappedFile 相同。
+    3. 空文件不做映射，data() 为 nullptr，size() 为 0。
+    4. 失败时抛出 std::system_error。映射期间其他进程截断文件，访问越界的页会收到 SIGBUS，这是 mmap 固有的限制。
+*/
+
+enum class MapMode { ReadOnly, ReadWrite };
+
+enum class AccessHint { Normal, Sequential, Random, WillNeed };
+
+class MappedFile {
+public:
+    static constexpr std::size_t KEEP_SIZE = static_cast<std::size_t>(-1);
+
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path, MapMode mode = MapMode::ReadOnly, AccessHint hint = AccessHint::Normal,
+                        std::size_t size = KEEP_SIZE);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::byte* data() const { return ptr; }
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    bool writable() const { return mode == MapMode::ReadWrite; }
+
+    std::span<const std::byte> bytes() const { return {ptr, length}; }
+    std::string_view view() const { return {reinterpret_cast<const char*>(ptr), length}; }
+    // 只有 ReadWrite 模式可用，否则抛出 std::logic_error
+    std::span<std::byte> writableBytes();
+
+    // 对 [offset, offset + len) 重新设置访问提示，范围会扩展到页边界
+    void advise(AccessHint hint, std::size_t offset = 0, std::size_t len = KEEP_SIZE);
+    // 把修改写回磁盘（msync），async 为 true 时只发起写回不等待
+    void sync(bool async = false);
+
+private:
+    void release() noexcept;
+
+    std::byte* ptr = nullptr;
+    std::size_t length = 0;
+    MapMode mode = MapMode::ReadOnly;
+};
+
+const char* accessHintName(AccessHint hint);
+
+// 基准测试：在 path 生成 bytes 大小的文件，对比 ifstream 与 MappedFile 的顺序扫描、随机 4KB 读取
+void benchMappedFile(const std::string& path, std::size_t bytes = std::size_t(1) << 30);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef __METADATACACHE__H__
+#define __METADATACACHE__H__
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "entryType.h"
+
+/*
+元数据缓存：MetadataCache
+    normalOperation / displayList 反复对同一批热点目录调用 fs::exists、fs::status 和目录遍历，每次都是系统调用
+（stat、openat + getdents64 + close），结果绝大多数时候和上一次完全一样。
+    做法：
+        1. 以路径为键缓存 lstat 的结果（是否存在、类型、大小、权限、修改时间）和目录列表，命中时直接从内存返回，没有系统调用；
+        2. 第一次缓存某个路径时，对它所在的目录（list 时是目录本身）及其各级上级目录加 inotify 监视；
+           目录中有文件创建、删除、改名、写入、属性变化时，内核发来事件，后台线程只作废对应的那一个条目和该目录的列表（增量失效），
+           其余缓存不受影响；路径上的某个目录（或符号链接）被删除、改名或替换时，它的上级目录收到事件，作废它下面的全部条目；
+           事件队列溢出（IN_Q_OVERFLOW）时清空整个缓存；
+        3. 同一个目录经不同路径访问（路径中有指向目录的符号链接、bind mount）时，inotify 返回同一个监视描述符，
+           每个监视描述符记录所有经由它缓存的路径，事件作废其中每一个路径下的条目；
+        4. 不存在的路径也缓存（负缓存）：父目录中出现同名文件时同样会收到事件；
+        5. 先加监视、再 stat，并用每个目录的“代数”判断 stat 期间是否来过事件，避免把过期的结果放进缓存。
+    限制：
+        1. inotify 是异步的：文件改变到缓存失效之间有极短的窗口（后台线程处理事件的时间），不适合要求强一致的场景；
+        2. 符号链接不缓存（status 跟随链接，目标的变化不会在链接所在目录产生事件），每次都直接 stat；
+        3. 通过别的目录中的硬链接修改同一个文件不会产生事件；mount/umount 改变路径的解析结果时也没有事件；
+        4. 监视数受 /proc/sys/fs/inotify/max_user_watches 限制，路径上任一级目录加不上监视（包括没有读权限）时不缓存，直接走系统调用；
+        5. 相对路径按构造时的工作目录解析。
+    线程安全：查询可以被多个线程同时调用（读写锁，命中时只加共享锁）。
+*/
+
+struct FileMeta {
+    bool exists = false;
+    EntryType type = EntryType::Other;
+    std::uint64_t size = 0;
+    std::uint32_t mode = 0;   // st_mode（类型位 + 权限位）
+    std::int64_t mtimeNs = 0; // 修改时间，纳秒
+};
+
+struct ListEntry {
+    std::string name;
+    EntryType type;
+};
+
+using DirListing = std::shared_ptr<const std::vector<ListEntry>>;
+
+struct MetadataCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;        // 每次未命中对应一次实际的 stat 或目录读取
+    std::uint64_t invalidations = 0; // 因 inotify 事件作废的条目数
+    std::uint64_t events = 0;        // 收到的 inotify 事件数
+    std::uint64_t syscalls = 0;      // 缓存自身发出的系统调用（stat、读目录、inotify_add_watch、后台线程的 poll/read）
+    std::size_t watches = 0;
+};
+
+class MetadataCache {
+public:
+    // inotify 不可用时抛出 std::system_error
+    MetadataCache();
+    ~MetadataCache();
+    MetadataCache(const MetadataCache&) = delete;
+    MetadataCache& operator=(const MetadataCache&) = delete;
+
+    bool exists(const std::string& path);
+    // 跟随符号链接（与 fs::status 相同）；不存在时 exists 为 false
+    FileMeta status(const std::string& path);
+    // 目录中的条目（不含 . 和 ..），目录不存在或无法读取时返回空列表
+    DirListing list(const std::string& dir);
+
+    MetadataCacheStats stats() const;
+
+private:
+    std::string normalize(const std::string& path) const;
+    // 确保 dir 已被监视，返回该目录当前的代数；无法监视时返回 -1
+    std::int64_t watchDir(const std::string& dir);
+    bool stillCurrent(const std::string& dir, std::int64_t generation) const;
+    void eventLoop();
+    bool watchedUnder(const std::string& path) const;
+    void unwatch(const std::string& dir);
+    void invalidateChild(const std::string& dir, const std::string& name);
+    void invalidateDir(const std::string& dir);
+
+    int inotifyFd = -1;
+    int wakeFd = -1; // 析构时唤醒后台线程
+    std::string cwd;
+
+    mutable std::shared_mutex mtx;
+    std::unordered_map<std::string, FileMeta> entries;
+    std::unordered_map<std::string, DirListing> listings;
+    std::unordered_map<int, std::vector<std::string>> wdToDirs; // 一个监视描述符可能对应同一目录的多个路径
+    std::map<std::string, int> dirToWd;                          // 有序，便于查找某个路径下被监视的目录
+    std::unordered_map<std::string, std::int64_t> generations; // 每个被监视目录收到事件的次数
+
+    std::atomic<std::uint64_t> hits{0}, misses{0}, invalidations{0}, events{0}, syscalls{0};
+    std::thread worker;
+};
+
+// 基准测试：对同一目录反复 exists/status/列目录，对比 std::filesystem、直接系统调用与 MetadataCache 的耗时和系统调用次数
+void benchMetadataCache(const std::string& dir, std::size_t files = 1000, std::size_t rounds = 100);
+
+#endif
@@ -0,0 +1,333 @@
+#include "appendWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "fileUtil.h"
+
+namespace {
+
+constexpr std::size_t BUFFER_ALIGNMENT = 4096;
+
+} // namespace
+
+AppendWriter::AppendWriter(const std::string& path, const AppendOptions& opts) : options(opts) {
+    options.bufferSize = std::max<std::size_t>(BUFFER_ALIGNMENT, options.bufferSize / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT);
+    options.bufferCount = std::max<std::size_t>(2, options.bufferCount);
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "AppendWriter: open " + path);
+    for (std::size_t i = 0; i < options.bufferCount; ++i) {
+        char* p = static_cast<char*>(std::aligned_alloc(BUFFER_ALIGNMENT, options.bufferSize));
+        if (!p) {
+            for (char* q : allBuffers) std::free(q);
+            close(fd);
+            throw std::bad_alloc();
+        }
+        allBuffers.push_back(p);
+    }
+    freeBuffers = allBuffers;
+    lastFlushNs = coarseNowNs();
+    if (options.backgroundFlush) flusher = std::thread([this]() { flusherLoop(); });
+}
+
+AppendWriter::~AppendWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (flusher.joinable()) flusher.join();
+    try {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!failure) writeOut(lock, true);
+    } catch (...) {
+        // 析构函数不能抛出；需要确认写出结果的调用方应在析构前调用 flush() 或 sync()
+    }
+    for (char* p : allBuffers) std::free(p);
+    close(fd);
+}
+
+void AppendWriter::rethrowFailure() {
+    if (failure) std::rethrow_exception(failure);
+}
+
+// 每次 append 都要检查，用 CLOCK_MONOTONIC_COARSE（精度为一个时钟节拍，开销只有普通时钟的几分之一）
+std::uint64_t AppendWriter::coarseNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+bool AppendWriter::intervalElapsed() const {
+    if (options.flushInterval.count() <= 0) return false;
+    return coarseNowNs() - lastFlushNs >= static_cast<std::uint64_t>(options.flushInterval.count()) * 1000000ull;
+}
+
+void AppendWriter::append(std::string_view data) {
+    std::unique_lock<std::mutex> lock(mtx);
+    appendParts(lock, {data});
+}
+
+void AppendWriter::appendLine(std::string_view line) {
+    std::unique_lock<std::mutex> lock(mtx);
+    appendParts(lock, {line, std::string_view("\n", 1)});
+}
+
+void AppendWriter::appendParts(std::unique_lock<std::mutex>& lock, std::initializer_list<std::string_view> parts) {
+    cv.wait(lock, [this]() { return !appendBusy || failure; });
+    rethrowFailure();
+    appendBusy = true; // 复制中途可能释放锁（等待空闲缓冲区），期间不允许其他 append 插入
+    // 只有复制中途释放过锁，其他线程才可能看到 appendBusy 并等待，此时才需要唤醒
+    struct BusyGuard {
+        AppendWriter* self;
+        ~BusyGuard() {
+            self->appendBusy = false;
+            if (self->lockReleased) self->cv.notify_all();
+            self->lockReleased = false;
+        }
+    };
+    {
+        BusyGuard guard{this};
+        for (std::string_view data : parts) copyIn(lock, data);
+    }
+    if (options.backgroundFlush) {
+        if (!sealed.empty()) cv.notify_all();
+    } else if (!sealed.empty()) {
+        writeOut(lock, false);
+    } else if (current.used > 0 && intervalElapsed()) {
+        writeOut(lock, true);
+    }
+}
+
+void AppendWriter::copyIn(std::unique_lock<std::mutex>& lock, std::string_view data) {
+    while (!data.empty()) {
+        if (!current.data) {
+            while (freeBuffers.empty()) {
+                lockReleased = true;
+                if (options.backgroundFlush) { // 背压：等待后台线程写出
+                    cv.notify_all();
+                    cv.wait(lock, [this]() { return !freeBuffers.empty() || failure; });
+                    rethrowFailure();
+                } else {
+                    writeOut(lock, false);
+                }
+            }
+            current = Buffer{freeBuffers.back(), 0};
+            freeBuffers.pop_back();
+        }
+        std::size_t n = std::min(options.bufferSize - current.used, data.size());
+        std::memcpy(current.data + current.used, data.data(), n);
+        current.used += n;
+        appended += n;
+        data.remove_prefix(n);
+        if (current.used == options.bufferSize) sealCurrent();
+    }
+}
+
+void AppendWriter::sealCurrent() {
+    if (current.data && current.used > 0) sealed.push_back(current);
+    else if (current.data) freeBuffers.push_back(current.data);
+    current = Buffer{nullptr, 0};
+}
+
+std::uint64_t AppendWriter::writeOut(std::unique_lock<std::mutex>& lock, bool includePartial) {
+    cv.wait(lock, [this]() { return !writing; });
+    if (includePartial) sealCurrent();
+    const std::uint64_t covered = appended - (current.data ? current.used : 0);
+    if (sealed.empty()) return covered;
+    std::vector<Buffer> batch;
+    batch.swap(sealed);
+    writing = true;
+    lock.unlock();
+
+    int error = 0;
+    std::vector<iovec> iov;
+    for (const Buffer& b : batch) iov.push_back(iovec{b.data, b.used});
+    std::uint64_t calls = 0;
+    for (std::size_t first = 0; first < iov.size() && !error;) {
+        ssize_t n = writev(fd, iov.data() + first, static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX)));
+        if (n < 0) {
+            if (errno != EINTR) error = errno;
+            continue;
+        }
+        ++calls;
+        // 部分写入：跳过已写完的 iovec，调整写了一半的那个
+        std::size_t done = static_cast<std::size_t>(n);
+        while (first < iov.size() && done >= iov[first].iov_len) done -= iov[first++].iov_len;
+        if (done > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + done;
+            iov[first].iov_len -= done;
+        }
+    }
+
+    lock.lock();
+    writing = false;
+    writes += calls;
+    lastFlushNs = coarseNowNs();
+    for (const Buffer& b : batch) freeBuffers.push_back(b.data);
+    cv.notify_all();
+    if (error) {
+        errno = error;
+        throwErrno("AppendWriter: writev");
+    }
+    return covered;
+}
+
+void AppendWriter::flush() {
+    std::unique_lock<std::mutex> lock(mtx);
+    rethrowFailure();
+    writeOut(lock, true);
+}
+
+void AppendWriter::sync() {
+    std::uint64_t target;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        rethrowFailure();
+        target = appended;
+    }
+    std::unique_lock<std::mutex> lk(syncMtx);
+    while (synced < target) {
+        if (syncing) { // 已有线程在 fdatasync：等它结束，它写出的数据可能已经包含了我们的
+            syncCv.wait(lk);
+            continue;
+        }
+        syncing = true;
+        lk.unlock();
+        std::uint64_t covered = 0;
+        int error = 0;
+        try {
+            std::unique_lock<std::mutex> lock(mtx);
+            covered = writeOut(lock, true);
+        } catch (...) {
+            lk.lock();
+            syncing = false;
+            syncCv.notify_all();
+            throw;
+        }
+        if (fdatasync(fd) != 0) error = errno;
+        lk.lock();
+        syncing = false;
+        ++syncs;
+        if (!error) synced = std::max(synced, covered);
+        syncCv.notify_all();
+        if (error) {
+            errno = error;
+            throwErrno("AppendWriter: fdatasync");
+        }
+    }
+}
+
+AppendStats AppendWriter::stats() const {
+    AppendStats s;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        s.bytes = appended;
+        s.writes = writes;
+    }
+    std::lock_guard<std::mutex> lock(syncMtx);
+    s.syncs = syncs;
+    return s;
+}
+
+void AppendWriter::flusherLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopping) {
+        auto wake = [this]() { return stopping || !sealed.empty(); };
+        if (options.flushInterval.count() > 0) cv.wait_for(lock, options.flushInterval, wake);
+        else cv.wait(lock, wake);
+        if (stopping) break;
+        try {
+            if (!sealed.empty()) writeOut(lock, false);
+            else if (current.used > 0 && intervalElapsed()) writeOut(lock, true);
+        } catch (...) {
+            failure = std::current_exception();
+            cv.notify_all();
+            break;
+        }
+    }
+}
+
+namespace {
+
+std::uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+}
+
+} // namespace
+
+void benchAppendWriter(const std::string& path, std::size_t lines) {
+    // 预先生成所有行，测量的只是写入本身
+    std::vector<std::string> text(lines);
+    std::uint64_t expected = 0;
+    for (std::size_t i = 0; i < lines; ++i) {
+        text[i] = "2024-06-01 12:00:00.000 INFO request id=" + std::to_string(i) + " latency_us=" + std::to_string(i * 7 % 1000);
+        expected += text[i].size() + 1;
+    }
+    std::cout << "追加写基准测试: " << path << ", " << lines << " 行, " << (expected >> 20) << " MB" << std::endl;
+    auto report = [&](const char* name, double sec, const std::string& extra = std::string()) {
+        std::uint64_t size = fileSize(path);
+        std::cout << name << ": " << static_cast<long>(lines / sec) << " 行/秒" << extra
+                  << checkMark(size == expected) << std::endl;
+        std::remove(path.c_str());
+    };
+    std::remove(path.c_str());
+
+    double sec = secondsOf([&]() {
+        std::ofstream out(path, std::ios::app);
+        for (const auto& line : text) out << line << std::endl;
+    });
+    report("[ofstream + endl]", sec);
+
+    sec = secondsOf([&]() {
+        std::ofstream out(path, std::ios::app);
+        for (const auto& line : text) out << line << '\n';
+    });
+    report("[ofstream + '\\n']", sec);
+
+    for (bool background : {false, true}) {
+        AppendStats s;
+        sec = secondsOf([&]() {
+            AppendOptions options;
+            options.backgroundFlush = background;
+            AppendWriter writer(path, options);
+            for (const auto& line : text) writer.appendLine(line);
+            writer.flush();
+            s = writer.stats();
+        });
+        report(background ? "[AppendWriter 后台写出]" : "[AppendWriter 同步写出]", sec,
+               ", writev " + std::to_string(s.writes) + " 次");
+    }
+
+    // 组提交：4 个线程各写一部分，每 100 行要求一次持久化
+    const std::size_t threads = 4, syncEvery = 100;
+    AppendStats s;
+    sec = secondsOf([&]() {
+        AppendWriter writer(path);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t)
+            workers.emplace_back([&, t]() {
+                for (std::size_t i = t; i < lines; i += threads) {
+                    writer.appendLine(text[i]);
+                    if ((i / threads) % syncEvery == syncEvery - 1) writer.sync();
+                }
+            });
+        for (auto& w : workers) w.join();
+        writer.sync();
+        s = writer.stats();
+    });
+    report("[AppendWriter 4 线程, 每 100 行 sync]", sec,
+           ", sync 调用 " + std::to_string(lines / syncEvery + 1) + " 次, 实际 fdatasync " + std::to_string(s.syncs) + " 次");
+}
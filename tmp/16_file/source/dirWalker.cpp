@@ -0,0 +1,261 @@
+#include "dirWalker.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <system_error>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "fileUtil.h"
+
+namespace {
+
+// getdents64 返回的目录项格式（glibc 没有导出这个结构体）
+struct LinuxDirent64 {
+    std::uint64_t d_ino;
+    std::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+constexpr std::size_t DIRENT_BUFFER_SIZE = 64 * 1024;
+
+struct DirTask {
+    std::string path;
+    int depth; // 该目录自身的深度，根目录为 0
+};
+
+class Walker {
+public:
+    Walker(const std::function<void(const DirEntry&)>& visit, const WalkOptions& options)
+        : visit(visit), options(options) {}
+
+    WalkStats run(int rootFd, std::string root) {
+        std::size_t threads = std::max<std::size_t>(1, options.threads);
+        pending = 1;
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            workers.emplace_back([this, i, rootFd, &root]() {
+                // 根目录由第一个线程处理，其余线程从共享队列开始等待
+                worker(i == 0 ? rootFd : -1, i == 0 ? std::move(root) : std::string());
+            });
+        for (auto& t : workers) t.join();
+        if (failure) std::rethrow_exception(failure);
+        return total;
+    }
+
+private:
+    void worker(int rootFd, std::string rootPath) {
+        WalkStats stats;
+        std::vector<DirTask> local; // 本线程发现、尚未处理的子目录，按栈使用（深度优先）
+        std::vector<char> buffer(DIRENT_BUFFER_SIZE);
+        std::string pathBuf;
+        try {
+            if (rootFd >= 0) {
+                finishDir(readDir(rootFd, DirTask{std::move(rootPath), 0}, local, buffer, pathBuf, stats));
+                share(local);
+            }
+            DirTask task;
+            while (next(local, task)) {
+                int fd = open(task.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+                if (fd < 0) {
+                    reportError(task.path, errno, stats);
+                    finishDir(0);
+                    continue;
+                }
+                finishDir(readDir(fd, std::move(task), local, buffer, pathBuf, stats));
+                share(local);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!failure) failure = std::current_exception();
+            done = true;
+            cv.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        total.entries += stats.entries;
+        total.directories += stats.directories;
+        total.statCalls += stats.statCalls;
+        total.errors += stats.errors;
+    }
+
+    // 读完一个目录（并关闭 fd），把子目录压入 local，返回压入的个数
+    std::size_t readDir(int fd, DirTask task, std::vector<DirTask>& local, std::vector<char>& buffer,
+                        std::string& pathBuf, WalkStats& stats) {
+        ++stats.directories;
+        std::size_t pushed = 0;
+        const bool descend = options.maxDepth < 0 || task.depth + 1 < options.maxDepth;
+        pathBuf = task.path;
+        if (pathBuf.empty() || pathBuf.back() != '/') pathBuf += '/';
+        const std::size_t prefix = pathBuf.size();
+        FdGuard closer{fd};
+        for (;;) {
+            long n = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+            if (n == 0) break;
+            if (n < 0) {
+                reportError(task.path, errno, stats);
+                break;
+            }
+            for (long offset = 0; offset < n;) {
+                auto* d = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+                offset += d->d_reclen;
+                const char* name = d->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+                EntryType type;
+                if (d->d_type == DT_UNKNOWN) {
+                    struct stat st;
+                    ++stats.statCalls;
+                    if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue; // 读目录与 stat 之间被删除
+                    type = typeFromMode(st.st_mode);
+                } else {
+                    type = typeFromDirent(d->d_type);
+                }
+                std::size_t nameLen = std::strlen(name);
+                pathBuf.resize(prefix);
+                pathBuf.append(name, nameLen);
+                DirEntry entry{pathBuf, std::string_view(pathBuf).substr(prefix), type, d->d_ino, task.depth + 1, fd};
+                WalkFilter decision = options.filter ? options.filter(entry) : WalkFilter::Accept;
+                if (decision == WalkFilter::Accept) {
+                    ++stats.entries;
+                    visit(entry);
+                }
+                if (type == EntryType::Directory && decision != WalkFilter::Prune && descend) {
+                    local.push_back(DirTask{pathBuf, task.depth + 1});
+                    ++pushed;
+                }
+            }
+        }
+        return pushed;
+    }
+
+    // 当前目录处理完：新发现的子目录先计入 pending，再扣掉自己，pending 归零即整棵树遍历结束
+    void finishDir(std::size_t discovered) {
+        if (discovered) pending.fetch_add(discovered, std::memory_order_relaxed);
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mtx);
+            done = true;
+            cv.notify_all();
+        }
+    }
+
+    bool next(std::vector<DirTask>& local, DirTask& task) {
+        if (!local.empty()) {
+            if (done.load(std::memory_order_relaxed)) return false; // 回调抛出异常，提前结束
+            task = std::move(local.back());
+            local.pop_back();
+            return true;
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        ++idle;
+        cv.wait(lock, [this]() { return done || !shared.empty(); });
+        --idle;
+        if (failure || shared.empty()) return false;
+        task = std::move(shared.front());
+        shared.pop_front();
+        return true;
+    }
+
+    // 有空闲线程时，把栈底的一半（最早发现、离根最近、通常子树最大）移到共享队列
+    void share(std::vector<DirTask>& local) {
+        if (local.size() < 2 || idle.load(std::memory_order_relaxed) == 0) return;
+        std::size_t count = local.size() / 2;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (std::size_t i = 0; i < count; ++i) shared.push_back(std::move(local[i]));
+        }
+        local.erase(local.begin(), local.begin() + count);
+        cv.notify_all();
+    }
+
+    void reportError(const std::string& path, int error, WalkStats& stats) {
+        ++stats.errors;
+        if (options.onError) options.onError(path, error);
+    }
+
+    const std::function<void(const DirEntry&)>& visit;
+    const WalkOptions& options;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<DirTask> shared;
+    std::atomic<std::size_t> idle{0};
+    std::atomic<std::size_t> pending{0}; // 已发现但尚未处理完的目录数
+    std::atomic<bool> done{false};
+    std::exception_ptr failure;
+    WalkStats total;
+};
+
+} // namespace
+
+WalkStats parallelWalk(const std::string& root, const std::function<void(const DirEntry&)>& visit,
+                       const WalkOptions& options) {
+    int fd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); // 根目录本身可以是指向目录的符号链接
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "parallelWalk: " + root);
+    if (options.maxDepth == 0) { // 根目录本身不报告，深度 0 之内没有任何条目
+        close(fd);
+        return WalkStats();
+    }
+    std::string path = root;
+    while (path.size() > 1 && path.back() == '/') path.pop_back();
+    Walker walker(visit, options);
+    return walker.run(fd, std::move(path));
+}
+
+void benchDirWalk(const std::string& root) {
+    namespace fs = std::filesystem;
+    std::cout << "目录遍历基准测试: " << root << "（先各跑一遍预热目录缓存，对比的是系统调用与 CPU 开销）" << std::endl;
+    std::size_t expected = 0;
+    auto iterate = [&]() {
+        std::size_t count = 0;
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+             it != end; it.increment(ec))
+            ++count;
+        return count;
+    };
+    expected = iterate();
+    double sec = secondsOf([&]() { expected = iterate(); });
+    std::cout << "[recursive_directory_iterator] 条目数: " << expected << ", 耗时: " << sec * 1e3 << " ms" << std::endl;
+
+    // displayList 的做法：directory_iterator 递归，每个条目再 is_directory 一次
+    std::size_t count = 0;
+    std::function<void(const fs::path&)> display = [&](const fs::path& dir) {
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; it != end; it.increment(ec)) {
+            ++count;
+            if (fs::is_directory(it->path(), ec) && !fs::is_symlink(it->path(), ec)) display(it->path());
+        }
+    };
+    sec = secondsOf([&]() { display(root); });
+    std::cout << "[directory_iterator + is_directory] 条目数: " << count << ", 耗时: " << sec * 1e3 << " ms"
+              << checkMark(count == expected) << std::endl;
+
+    std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t previous = 0;
+    for (std::size_t threads : {std::size_t(1), hw, hw * 4}) {
+        if (threads == previous) continue;
+        previous = threads;
+        WalkOptions options;
+        options.threads = threads;
+        std::atomic<std::size_t> visited{0};
+        WalkStats stats;
+        sec = secondsOf([&]() {
+            stats = parallelWalk(root, [&](const DirEntry&) { visited.fetch_add(1, std::memory_order_relaxed); }, options);
+        });
+        std::cout << "[parallelWalk " << threads << " 线程] 条目数: " << stats.entries << ", 目录数: " << stats.directories
+                  << ", 补做 stat: " << stats.statCalls << ", 错误: " << stats.errors << ", 耗时: " << sec * 1e3 << " ms"
+                  << checkMark(visited == expected && stats.entries == expected) << std::endl;
+    }
+}
@@ -0,0 +1,374 @@
+#include "directFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "asyncIo.h"
+#include "fileUtil.h"
+
+namespace {
+
+constexpr std::size_t MIN_ALIGNMENT = 4096;
+constexpr std::uint64_t FOLIO_SLACK = std::uint64_t(64) << 20; // 大于任何页缓存大页块，丢弃范围的起点按它向下对齐
+
+std::size_t roundUp(std::size_t n, std::size_t align) { return (n + align - 1) / align * align; }
+
+// 文件要求的直接 I/O 对齐（至少 4 KB）；返回 0 表示该文件不支持直接 I/O
+std::size_t directAlignment(int fd) {
+#ifdef STATX_DIOALIGN
+    struct statx stx;
+    if (statx(fd, "", AT_EMPTY_PATH, STATX_DIOALIGN, &stx) == 0 && (stx.stx_mask & STATX_DIOALIGN)) {
+        if (stx.stx_dio_offset_align == 0) return 0;
+        return std::max<std::size_t>({MIN_ALIGNMENT, stx.stx_dio_mem_align, stx.stx_dio_offset_align});
+    }
+#endif
+    return MIN_ALIGNMENT; // 内核或 C 库太旧，无法查询：4 KB 是所有常见设备逻辑块大小的倍数
+}
+
+// 先带 O_DIRECT 打开；文件系统拒绝时按 allowFallback 改用普通 I/O 或抛出异常
+int openDirect(const std::string& path, int flags, bool allowFallback, bool& direct, std::size_t& alignment) {
+    int fd = open(path.c_str(), flags | O_DIRECT | O_CLOEXEC, 0644);
+    direct = fd >= 0;
+    if (fd < 0) {
+        if (errno != EINVAL || !allowFallback) throwErrno("open(O_DIRECT) " + path);
+        fd = open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd < 0) throwErrno("open " + path);
+    }
+    alignment = direct ? directAlignment(fd) : MIN_ALIGNMENT;
+    if (alignment == 0) { // open 接受了 O_DIRECT，但该文件实际不支持
+        if (!allowFallback) {
+            close(fd);
+            throwErrno(EINVAL, "O_DIRECT not supported: " + path);
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+        direct = false;
+        alignment = MIN_ALIGNMENT;
+    }
+    return fd;
+}
+
+// 后备模式：丢弃 [dropped, end) 的页缓存（end 为 0 表示到文件末尾），并推进 dropped
+void dropPages(int fd, std::uint64_t& dropped, std::uint64_t end) {
+    std::uint64_t start = dropped / FOLIO_SLACK * FOLIO_SLACK;
+    posix_fadvise(fd, static_cast<off_t>(start), end ? static_cast<off_t>(end - start) : 0, POSIX_FADV_DONTNEED);
+    if (end) dropped = end;
+}
+
+} // namespace
+
+AlignedBufferPool::AlignedBufferPool(std::size_t bufferSize, std::size_t count, std::size_t alignment)
+    : size(roundUp(std::max<std::size_t>(bufferSize, 1), alignment)), align(alignment) {
+    for (std::size_t i = 0; i < count; ++i) {
+        char* p = static_cast<char*>(std::aligned_alloc(align, size));
+        if (!p) {
+            for (char* b : buffers) std::free(b);
+            throw std::bad_alloc();
+        }
+        buffers.push_back(p);
+    }
+    freeBuffers = buffers;
+}
+
+AlignedBufferPool::~AlignedBufferPool() {
+    for (char* p : buffers) std::free(p);
+}
+
+char* AlignedBufferPool::acquire() {
+    if (freeBuffers.empty()) return nullptr;
+    char* p = freeBuffers.back();
+    freeBuffers.pop_back();
+    return p;
+}
+
+void AlignedBufferPool::release(char* buffer) { freeBuffers.push_back(buffer); }
+
+DirectReader::DirectReader(const std::string& path, const DirectOptions& options) {
+    std::size_t alignment;
+    fd = openDirect(path, O_RDONLY, options.allowFallback, isDirect, alignment);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int error = errno;
+        close(fd);
+        throwErrno(error, "fstat " + path);
+    }
+    fileSize = static_cast<std::uint64_t>(st.st_size);
+    if (!isDirect) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    const std::size_t count = std::max<std::size_t>(2, options.buffers);
+    pool = std::make_unique<AlignedBufferPool>(options.bufferSize, count, alignment);
+    io = std::make_unique<AsyncIo>(static_cast<unsigned>(count));
+}
+
+DirectReader::~DirectReader() {
+    io.reset(); // 先等在途请求完成，再关闭文件
+    if (!isDirect) dropPages(fd, dropped, 0); // 包括预读进来、尚未交给调用方的部分
+    close(fd);
+}
+
+// 用所有空闲缓冲区发起后续的读请求
+void DirectReader::issue() {
+    bool any = false;
+    while (nextOffset < fileSize && pool->available() > 0) {
+        auto p = std::make_shared<Pending>(Pending{pool->acquire(), nextOffset, 0, false});
+        // 最后一块同样按整块（对齐）的长度读，内核只返回实际剩余的字节
+        io->read(IoFile::fd(fd), p->buffer, pool->bufferSize(), static_cast<off_t>(nextOffset), [p](int result) {
+            p->result = result;
+            p->done = true;
+        });
+        pending.push_back(std::move(p));
+        nextOffset += pool->bufferSize();
+        any = true;
+    }
+    if (any) io->submit();
+}
+
+bool DirectReader::next(std::span<const std::byte>& block) {
+    if (current) {
+        if (!isDirect) dropPages(fd, dropped, current->offset + static_cast<std::uint64_t>(current->result));
+        pool->release(current->buffer);
+        current.reset();
+    }
+    issue();
+    if (pending.empty()) return false;
+    std::shared_ptr<Pending> front = std::move(pending.front());
+    pending.pop_front();
+    while (!front->done) io->poll(1);
+    const std::uint64_t expected = std::min<std::uint64_t>(pool->bufferSize(), fileSize - front->offset);
+    if (front->result < 0 || static_cast<std::uint64_t>(front->result) != expected) {
+        pool->release(front->buffer);
+        throwErrno(front->result < 0 ? -front->result : EIO, "DirectReader: read");
+    }
+    current = std::move(front);
+    issue(); // 刚才没有空闲缓冲区时，这里不会发起新请求；调用方处理本块期间已有其余缓冲区在读
+    block = std::span<const std::byte>(reinterpret_cast<const std::byte*>(current->buffer), current->result);
+    return true;
+}
+
+DirectWriter::DirectWriter(const std::string& path, const DirectOptions& options) {
+    std::size_t alignment;
+    fd = openDirect(path, O_WRONLY | O_CREAT | O_TRUNC, options.allowFallback, isDirect, alignment);
+    const std::size_t count = std::max<std::size_t>(2, options.buffers);
+    pool = std::make_unique<AlignedBufferPool>(options.bufferSize, count, alignment);
+    io = std::make_unique<AsyncIo>(static_cast<unsigned>(count));
+}
+
+DirectWriter::~DirectWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+    io.reset();
+    ::close(fd);
+}
+
+void DirectWriter::rethrowFailure() {
+    if (failure) std::rethrow_exception(failure);
+}
+
+void DirectWriter::write(const void* data, std::size_t len) {
+    if (closed) throw std::logic_error("DirectWriter: write after close");
+    rethrowFailure();
+    const char* src = static_cast<const char*>(data);
+    written += len;
+    while (len > 0) {
+        if (!current) {
+            while (!(current = pool->acquire())) io->poll(1); // 所有缓冲区都在写：等一个写完
+            rethrowFailure();
+        }
+        std::size_t n = std::min(len, pool->bufferSize() - used);
+        std::memcpy(current + used, src, n);
+        used += n;
+        src += n;
+        len -= n;
+        if (used == pool->bufferSize()) submitCurrent(used);
+    }
+}
+
+void DirectWriter::submitCurrent(std::size_t len) {
+    char* buffer = current;
+    const std::uint64_t offset = submitted;
+    io->write(IoFile::fd(fd), buffer, len, static_cast<off_t>(offset), [this, buffer, offset, len](int result) {
+        pool->release(buffer);
+        if (result != static_cast<int>(len)) {
+            if (!failure)
+                failure = std::make_exception_ptr(
+                    std::system_error(result < 0 ? -result : ENOSPC, std::generic_category(), "DirectWriter: write"));
+            return;
+        }
+        if (!isDirect) {
+            // 后备模式：本块开始写回；之前的块等写回完成后从页缓存丢弃
+            sync_file_range(fd, static_cast<off_t>(offset), static_cast<off_t>(len), SYNC_FILE_RANGE_WRITE);
+            if (offset > dropped) {
+                sync_file_range(fd, static_cast<off_t>(dropped), static_cast<off_t>(offset - dropped),
+                                SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+                dropPages(fd, dropped, offset);
+            }
+        }
+    });
+    io->submit();
+    submitted += len;
+    current = nullptr;
+    used = 0;
+}
+
+void DirectWriter::close() {
+    if (closed) return;
+    closed = true;
+    bool padded = false;
+    if (used > 0) {
+        std::size_t len = used;
+        if (isDirect) { // 尾部补 0 到对齐长度，写完后再截断
+            len = roundUp(used, pool->alignment());
+            std::memset(current + used, 0, len - used);
+            padded = len != used;
+        }
+        submitCurrent(len);
+    }
+    io->wait();
+    rethrowFailure();
+    if (padded && ftruncate(fd, static_cast<off_t>(written)) != 0) throwErrno("DirectWriter: ftruncate");
+    if (!isDirect && written > dropped) {
+        sync_file_range(fd, static_cast<off_t>(dropped), 0,
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        dropPages(fd, dropped, 0);
+        dropped = written;
+    }
+}
+
+void DirectWriter::sync() {
+    close();
+    if (fdatasync(fd) != 0) throwErrno("DirectWriter: fdatasync");
+}
+
+namespace {
+
+// 文件当前在页缓存中驻留的字节数（mmap + mincore）
+std::uint64_t residentBytes(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    struct stat st;
+    fstat(fd, &st);
+    std::uint64_t resident = 0;
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    if (st.st_size > 0) {
+        void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            std::vector<unsigned char> pages((static_cast<std::size_t>(st.st_size) + page - 1) / page);
+            if (mincore(p, static_cast<std::size_t>(st.st_size), pages.data()) == 0)
+                for (unsigned char v : pages) resident += (v & 1) ? page : 0;
+            munmap(p, static_cast<std::size_t>(st.st_size));
+        }
+    }
+    close(fd);
+    return resident;
+}
+
+void dropCache(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// 按 8 字节字求和，块的起点都是 8 的倍数，各种分块方式的结果相同
+std::uint64_t checksum(const char* p, std::size_t len) {
+    std::uint64_t sum = 0, word;
+    std::size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        std::memcpy(&word, p + i, 8);
+        sum += word;
+    }
+    for (; i < len; ++i) sum += static_cast<unsigned char>(p[i]);
+    return sum;
+}
+
+void fillChunk(std::vector<char>& chunk, std::uint64_t offset) {
+    for (std::size_t i = 0; i + 8 <= chunk.size(); i += 8) {
+        std::uint64_t v = (offset + i) * 0x9E3779B97F4A7C15ULL;
+        std::memcpy(chunk.data() + i, &v, 8);
+    }
+}
+
+} // namespace
+
+void benchDirectIo(const std::string& path, std::size_t bytes) {
+    const std::size_t total = bytes + 1234; // 故意不是块大小的倍数，覆盖尾部处理
+    const std::size_t chunkSize = std::size_t(1) << 20;
+    std::vector<char> chunk(chunkSize);
+    std::uint64_t expected = 0;
+    auto report = [&](const std::string& name, double sec, std::uint64_t sum) {
+        std::cout << "[" << name << "] " << total / sec / 1e9 << " GB/s, 页缓存驻留 " << residentBytes(path) / 1e6 << " MB"
+                  << checkMark(sum == expected) << std::endl;
+    };
+
+    double sec = secondsOf([&]() {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        for (std::size_t off = 0; off < total; off += chunkSize) {
+            std::size_t n = std::min(chunkSize, total - off);
+            fillChunk(chunk, off);
+            expected += checksum(chunk.data(), n);
+            out.write(chunk.data(), static_cast<std::streamsize>(n));
+        }
+        out.close();
+        dropCache(path); // 含 fdatasync，与 DirectWriter::sync 对等
+    });
+    {
+        DirectWriter probe(path + ".probe");
+        std::cout << "直接 I/O 基准测试: " << total / 1e6 << " MB, "
+                  << (probe.direct() ? "O_DIRECT, 对齐 " + std::to_string(probe.alignment()) + " 字节"
+                                     : std::string("文件系统不支持 O_DIRECT，使用后备模式"))
+                  << std::endl;
+    }
+    unlink((path + ".probe").c_str());
+    std::cout << "[ofstream 写入 + fdatasync] " << total / sec / 1e9 << " GB/s（写完后已丢弃页缓存）" << std::endl;
+
+    for (std::size_t buffers : {std::size_t(2), std::size_t(8)}) {
+        std::uint64_t sum = 0;
+        sec = secondsOf([&]() {
+            DirectOptions options;
+            options.buffers = buffers;
+            DirectWriter writer(path, options);
+            for (std::size_t off = 0; off < total; off += chunkSize) {
+                std::size_t n = std::min(chunkSize, total - off);
+                fillChunk(chunk, off);
+                sum += checksum(chunk.data(), n);
+                writer.write(chunk.data(), n);
+            }
+            writer.sync();
+        });
+        report("DirectWriter x" + std::to_string(buffers) + " 缓冲 + fdatasync", sec, sum);
+    }
+
+    dropCache(path);
+    std::uint64_t sum = 0;
+    sec = secondsOf([&]() {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        ssize_t n;
+        while ((n = read(fd, chunk.data(), chunk.size())) > 0) sum += checksum(chunk.data(), static_cast<std::size_t>(n));
+        close(fd);
+    });
+    report("read 1MB（页缓存）", sec, sum);
+
+    for (std::size_t buffers : {std::size_t(2), std::size_t(8)}) {
+        dropCache(path);
+        sum = 0;
+        sec = secondsOf([&]() {
+            DirectOptions options;
+            options.buffers = buffers;
+            DirectReader reader(path, options);
+            std::span<const std::byte> block;
+            while (reader.next(block)) sum += checksum(reinterpret_cast<const char*>(block.data()), block.size());
+        });
+        report("DirectReader x" + std::to_string(buffers) + " 缓冲", sec, sum);
+    }
+    unlink(path.c_str());
+}
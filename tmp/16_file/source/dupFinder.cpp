@@ -0,0 +1,533 @@
+#include "dupFinder.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bulkStat.h"
+#include "fileUtil.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::uint64_t P1 = 11400714785074694791ULL;
+constexpr std::uint64_t P2 = 14029467366897019727ULL;
+constexpr std::uint64_t P3 = 1609587929392839161ULL;
+constexpr std::uint64_t P4 = 9650029242287828579ULL;
+constexpr std::uint64_t P5 = 2870177450012600261ULL;
+
+inline std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline std::uint64_t read64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint32_t read32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t round64(std::uint64_t acc, std::uint64_t input) { return rotl(acc + input * P2, 31) * P1; }
+
+inline std::uint64_t mergeRound(std::uint64_t acc, std::uint64_t val) { return (acc ^ round64(0, val)) * P1 + P4; }
+
+// 四路累加器每轮处理 32 字节
+inline void stripe(std::uint64_t v[4], const unsigned char* p) {
+    v[0] = round64(v[0], read64(p));
+    v[1] = round64(v[1], read64(p + 8));
+    v[2] = round64(v[2], read64(p + 16));
+    v[3] = round64(v[3], read64(p + 24));
+}
+
+inline std::uint64_t converge(const std::uint64_t v[4]) {
+    std::uint64_t h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+    for (int i = 0; i < 4; ++i) h = mergeRound(h, v[i]);
+    return h;
+}
+
+// 不满 32 字节的尾部与最后的混合；h 已经加上总长度
+std::uint64_t finalize(std::uint64_t h, const unsigned char* p, const unsigned char* end) {
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ round64(0, read64(p)), 27) * P1 + P4;
+    if (p + 4 <= end) {
+        h = rotl(h ^ (read32(p) * P1), 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; ++p) h = rotl(h ^ (*p * P5), 11) * P1;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+// 流式 XXH64：数据可以分多次 update，结果与对整段数据调用 xxh64 相同
+class Xxh64Stream {
+public:
+    explicit Xxh64Stream(std::uint64_t seed = 0) : seed(seed), v{seed + P1 + P2, seed + P2, seed, seed - P1} {}
+
+    void update(const void* data, std::size_t len) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        total += len;
+        if (buffered + len < 32) {
+            std::memcpy(pending + buffered, p, len);
+            buffered += len;
+            return;
+        }
+        if (buffered > 0) {
+            std::size_t fill = 32 - buffered;
+            std::memcpy(pending + buffered, p, fill);
+            stripe(v, pending);
+            p += fill, len -= fill, buffered = 0;
+        }
+        for (; len >= 32; p += 32, len -= 32) stripe(v, p);
+        std::memcpy(pending, p, len);
+        buffered = len;
+    }
+
+    std::uint64_t digest() const {
+        std::uint64_t h = total >= 32 ? converge(v) : seed + P5;
+        return finalize(h + total, pending, pending + buffered);
+    }
+
+private:
+    std::uint64_t seed;
+    std::uint64_t v[4];
+    unsigned char pending[32];
+    std::size_t buffered = 0;
+    std::uint64_t total = 0;
+};
+
+} // namespace
+
+std::uint64_t xxh64(const void* data, std::size_t len, std::uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    std::uint64_t h;
+    if (len >= 32) {
+        // 四路独立的累加器，每轮处理 32 字节，互不依赖，CPU 可以并行执行
+        std::uint64_t v[4] = {seed + P1 + P2, seed + P2, seed, seed - P1};
+        for (const unsigned char* limit = end - 32; p <= limit; p += 32) stripe(v, p);
+        h = converge(v);
+    } else {
+        h = seed + P5;
+    }
+    return finalize(h + len, p, end);
+}
+
+std::uint64_t DuplicateReport::duplicateFiles() const {
+    std::uint64_t n = 0;
+    for (const auto& g : groups) n += g.paths.size() - 1;
+    return n;
+}
+
+std::uint64_t DuplicateReport::reclaimableBytes() const {
+    std::uint64_t n = 0;
+    for (const auto& g : groups) n += g.size * (g.paths.size() - 1);
+    return n;
+}
+
+namespace {
+
+enum class Stage { Partial, Full, Verify };
+
+struct Candidate {
+    std::string path;
+    std::uint64_t size;
+    std::uint64_t hash = 0; // 当前阶段的结果：部分哈希，之后是完整哈希
+    bool failed = false;    // 打不开、读取失败或校验不一致
+};
+
+struct Group {
+    Stage stage;
+    std::vector<std::size_t> members; // Verify 阶段 members[0] 是比较的基准
+    std::atomic<std::size_t> remaining{0};
+    std::atomic<bool> baseFailed{false}; // Verify 阶段基准文件读取失败，需要换一个基准
+};
+
+struct Task {
+    Stage stage;
+    std::size_t file;
+    Group* group;
+};
+
+// 完整哈希与校验每次读取的块大小
+constexpr std::size_t READ_BLOCK = std::size_t(1) << 20;
+
+// 读满 len 字节；出错或提前遇到文件末尾（文件被截短）时返回 false
+bool preadFull(int fd, char* buf, std::size_t len, off_t offset) {
+    while (len > 0) {
+        ssize_t n = pread(fd, buf, len, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        len -= static_cast<std::size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+// 打开文件并确认大小仍与遍历时相同；打不开或大小已变时返回 -1
+int openUnchanged(const std::string& path, std::uint64_t size) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) != size) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+class DuplicateFinder {
+public:
+    DuplicateFinder(const DuplicateOptions& options, DuplicateReport& report) : options(options), report(report) {}
+
+    void run(const std::string& root) {
+        collect(root);
+        std::size_t threads = std::max<std::size_t>(1, options.threads);
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < threads; ++i) workers.emplace_back([this]() { work(); });
+        work();
+        for (auto& w : workers) w.join();
+        report.fullHashed = fullHashed;
+        report.bytesRead = bytesRead;
+        report.errors += errors;
+        report.groups = std::move(results);
+        for (auto& g : report.groups) std::sort(g.paths.begin(), g.paths.end());
+        std::sort(report.groups.begin(), report.groups.end(), [](const DuplicateGroup& a, const DuplicateGroup& b) {
+            return a.size * (a.paths.size() - 1) > b.size * (b.paths.size() - 1);
+        });
+    }
+
+private:
+    // 第 1 级：遍历 + statx，去掉硬链接，按大小分组；大小相同的文件生成部分哈希任务
+    void collect(const std::string& root) {
+        BulkStatOptions statOptions;
+        statOptions.fields = StatType | StatSize | StatInode | StatDevice;
+        statOptions.threads = options.threads;
+        StatTable t = bulkStatTree(root, statOptions, options.walk);
+        std::unordered_map<std::uint64_t, std::unordered_set<std::uint64_t>> seenInodes; // 设备号 -> inode
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> bySize;
+        for (std::size_t i = 0; i < t.count(); ++i) {
+            if (t.error[i]) {
+                ++report.errors;
+                continue;
+            }
+            if (t.type[i] != EntryType::File || t.size[i] < options.minSize) continue;
+            if (!seenInodes[t.device[i]].insert(t.inode[i]).second) {
+                ++report.hardLinks;
+                continue;
+            }
+            bySize[t.size[i]].push_back(files.size());
+            files.push_back(Candidate{std::string(t.path(i)), t.size[i]});
+        }
+        report.files = files.size();
+        for (auto& [size, members] : bySize) {
+            if (members.size() < 2) continue;
+            report.partialHashed += members.size();
+            schedule(Stage::Partial, std::move(members));
+        }
+    }
+
+    // 调用方负责把新任务计入 outstanding 之后才完成自己的任务，工作线程不会提前退出
+    void schedule(Stage stage, std::vector<std::size_t> members) {
+        std::lock_guard<std::mutex> lock(mtx);
+        groups.emplace_back();
+        Group& g = groups.back();
+        g.stage = stage;
+        g.members = std::move(members);
+        std::size_t first = stage == Stage::Verify ? 1 : 0; // 基准文件自己不用比较
+        g.remaining = g.members.size() - first;
+        for (std::size_t k = first; k < g.members.size(); ++k) tasks.push_back(Task{stage, g.members[k], &g});
+        outstanding += g.members.size() - first;
+        cv.notify_all();
+    }
+
+    void work() {
+        std::vector<char> buffer(std::max(2 * options.partialBytes, 2 * READ_BLOCK)); // 校验时前后两半各放一个文件的块
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this]() { return !tasks.empty() || outstanding == 0; });
+                if (tasks.empty()) return;
+                // 后进先出：优先推进已经开始的组，结果尽早产生，刚读过的文件头尾也还在页缓存里
+                task = tasks.back();
+                tasks.pop_back();
+            }
+            execute(task, buffer);
+            if (--task.group->remaining == 0) finish(*task.group);
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--outstanding == 0) cv.notify_all();
+        }
+    }
+
+    void execute(const Task& task, std::vector<char>& buffer) {
+        Candidate& c = files[task.file];
+        bool ok = true;
+        if (task.stage == Stage::Partial) {
+            ok = partialHash(c, buffer);
+        } else if (task.stage == Stage::Full) {
+            ok = fullHash(c, buffer);
+        } else {
+            switch (compareWithBase(*task.group, c, buffer)) {
+            case Compare::Same: break;
+            case Compare::Different: c.failed = true; break;
+            case Compare::Error: ok = false; break;
+            case Compare::BaseError: task.group->baseFailed = true; break; // 与 c 无关，finish 中换基准重新校验
+            }
+        }
+        if (!ok) {
+            c.failed = true;
+            ++errors;
+        }
+    }
+
+    // 开头和末尾各 partialBytes；文件不超过 2 * partialBytes 时就是完整内容
+    bool partialHash(Candidate& c, std::vector<char>& buffer) {
+        FdGuard fd{openUnchanged(c.path, c.size)};
+        if (fd.fd < 0) return false;
+        std::size_t head = static_cast<std::size_t>(std::min<std::uint64_t>(c.size, options.partialBytes));
+        std::size_t tail = static_cast<std::size_t>(std::min<std::uint64_t>(c.size - head, options.partialBytes));
+        if (!preadFull(fd.fd, buffer.data(), head, 0) ||
+            !preadFull(fd.fd, buffer.data() + head, tail, static_cast<off_t>(c.size - tail)))
+            return false;
+        bytesRead += head + tail;
+        c.hash = xxh64(buffer.data(), head + tail);
+        return true;
+    }
+
+    // 分块 pread 流式计算哈希：扫描期间被截短的文件若用 mmap 访问，越过新文件末尾的页会触发 SIGBUS，pread 只会提前读到末尾
+    bool fullHash(Candidate& c, std::vector<char>& buffer) {
+        FdGuard fd{openUnchanged(c.path, c.size)};
+        if (fd.fd < 0) return false;
+        posix_fadvise(fd.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        Xxh64Stream hash;
+        for (std::uint64_t off = 0; off < c.size;) {
+            std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(READ_BLOCK, c.size - off));
+            if (!preadFull(fd.fd, buffer.data(), n, static_cast<off_t>(off))) return false;
+            hash.update(buffer.data(), n);
+            off += n;
+        }
+        bytesRead += c.size;
+        c.hash = hash.digest();
+        return true;
+    }
+
+    enum class Compare { Same, Different, Error, BaseError };
+
+    Compare compareWithBase(const Group& g, const Candidate& c, std::vector<char>& buffer) {
+        const Candidate& base = files[g.members[0]];
+        FdGuard a{openUnchanged(base.path, base.size)};
+        if (a.fd < 0) return Compare::BaseError;
+        FdGuard b{openUnchanged(c.path, c.size)};
+        if (b.fd < 0) return Compare::Error;
+        posix_fadvise(b.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        char* x = buffer.data();
+        char* y = x + READ_BLOCK;
+        for (std::uint64_t off = 0; off < c.size;) {
+            std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(READ_BLOCK, c.size - off));
+            if (!preadFull(a.fd, x, n, static_cast<off_t>(off))) return Compare::BaseError;
+            if (!preadFull(b.fd, y, n, static_cast<off_t>(off))) return Compare::Error;
+            bytesRead += n; // 基准文件第一次读过之后一直在页缓存中，不重复计入
+            if (std::memcmp(x, y, n) != 0) return Compare::Different;
+            off += n;
+        }
+        return Compare::Same;
+    }
+
+    bool coveredByPartial(std::uint64_t size) const { return size <= 2 * options.partialBytes; }
+
+    // 一个组的所有任务都完成：按本阶段的结果重新分组，仍有同伴的文件进入下一阶段或成为结果
+    void finish(Group& g) {
+        if (g.stage == Stage::Verify) {
+            std::vector<std::size_t> same;
+            if (g.baseFailed) {
+                // 基准文件读不了：计一次错误，其余文件以组内下一个文件为基准重新校验
+                files[g.members[0]].failed = true;
+                ++errors;
+                for (std::size_t k = 1; k < g.members.size(); ++k)
+                    if (!files[g.members[k]].failed) same.push_back(g.members[k]);
+                if (same.size() >= 2) schedule(Stage::Verify, std::move(same));
+                return;
+            }
+            for (std::size_t k : g.members)
+                if (!files[k].failed) same.push_back(k);
+            if (same.size() >= 2) emit(same);
+            return;
+        }
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> byHash;
+        for (std::size_t k : g.members)
+            if (!files[k].failed) byHash[files[k].hash].push_back(k);
+        for (auto& [hash, members] : byHash) {
+            if (members.size() < 2) continue;
+            bool complete = g.stage == Stage::Full || coveredByPartial(files[members[0]].size);
+            if (!complete) {
+                fullHashed += members.size();
+                schedule(Stage::Full, std::move(members));
+            } else if (options.verify) {
+                schedule(Stage::Verify, std::move(members));
+            } else {
+                emit(members);
+            }
+        }
+    }
+
+    void emit(const std::vector<std::size_t>& members) {
+        DuplicateGroup result;
+        result.size = files[members[0]].size;
+        result.hash = files[members[0]].hash;
+        for (std::size_t k : members) result.paths.push_back(files[k].path);
+        std::lock_guard<std::mutex> lock(mtx);
+        results.push_back(std::move(result));
+    }
+
+    const DuplicateOptions& options;
+    DuplicateReport& report;
+    std::vector<Candidate> files; // collect 之后不再增删，各任务只改自己那一项
+
+    std::mutex mtx; // 保护以下四项
+    std::condition_variable cv;
+    std::vector<Task> tasks;
+    std::deque<Group> groups; // deque 追加元素不会移动已有元素，任务中的 Group* 保持有效
+    std::size_t outstanding = 0; // 已排队或正在执行的任务数
+    std::vector<DuplicateGroup> results;
+
+    std::atomic<std::uint64_t> bytesRead{0}, errors{0}, fullHashed{0};
+};
+
+} // namespace
+
+DuplicateReport findDuplicates(const std::string& root, const DuplicateOptions& options) {
+    DuplicateReport report;
+    auto start = std::chrono::steady_clock::now();
+    DuplicateFinder finder(options, report);
+    finder.run(root);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    report.seconds = elapsed.count();
+    return report;
+}
+
+void printDuplicateReport(const DuplicateReport& report, std::ostream& out, std::size_t maxGroups) {
+    out << "文件 " << report.files << " 个（跳过硬链接 " << report.hardLinks << " 个）-> 大小相同 " << report.partialHashed
+        << " -> 头尾相同 " << report.fullHashed << " -> 重复 " << report.duplicateFiles() + report.groups.size()
+        << "；读取 " << report.bytesRead / 1e6 << " MB, 错误 " << report.errors << ", 耗时 " << report.seconds << " 秒\n";
+    out << report.groups.size() << " 组重复，可回收 " << report.reclaimableBytes() / 1e6 << " MB\n";
+    for (std::size_t i = 0; i < report.groups.size() && i < maxGroups; ++i) {
+        const DuplicateGroup& g = report.groups[i];
+        out << "  [" << g.paths.size() << " x " << g.size << " 字节, xxh64 " << std::hex << g.hash << std::dec << "]\n";
+        for (const auto& p : g.paths) out << "    " << p << "\n";
+    }
+    if (report.groups.size() > maxGroups) out << "  ...（其余 " << report.groups.size() - maxGroups << " 组省略）\n";
+}
+
+namespace {
+
+void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary).write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+} // namespace
+
+void benchDuplicateFinder(const std::string& dir, std::size_t files) {
+    if (xxh64("", 0) != 0xEF46DB3751D8E999ULL || xxh64("abc", 3) != 0x44BC2CF5AD770999ULL)
+        std::cout << "xxh64 与参考值不一致 (校验失败!)" << std::endl;
+
+    const fs::path root = fs::path(dir) / "dup_bench";
+    fs::remove_all(root);
+    const std::size_t big = 256 * 1024;
+    std::string pattern(big, '\0');
+    for (std::size_t i = 0; i < big; ++i) pattern[i] = static_cast<char>('a' + i * 7 % 26);
+    std::size_t expectBig = 0, expectSmall = 0, links = 0;
+    fs::path firstBig;
+    for (std::size_t i = 0; i < files; ++i) {
+        fs::path sub = root / ("d" + std::to_string(i / 100));
+        if (i % 100 == 0) fs::create_directories(sub);
+        fs::path path = sub / ("f" + std::to_string(i));
+        std::string tag = std::to_string(i);
+        std::string content;
+        switch (i % 10) {
+        case 2: // 大小相同、开头不同：部分哈希排除
+            content = pattern.substr(0, 32 * 1024);
+            content.replace(0, tag.size(), tag);
+            break;
+        case 3: // 大小、开头、末尾都相同，只有中间不同：完整哈希排除
+            content = pattern;
+            content.replace(big / 2, tag.size(), tag);
+            break;
+        case 4: // 完全相同的大文件
+            content = pattern;
+            content.replace(big / 2, 5, "DUPLI");
+            ++expectBig;
+            break;
+        case 5: // 完全相同的小文件（部分哈希即完整内容）
+            content = pattern.substr(0, 2000);
+            ++expectSmall;
+            break;
+        case 6: // 指向第一个重复大文件的硬链接
+            if (!firstBig.empty()) {
+                fs::create_hard_link(firstBig, path);
+                ++links;
+                continue;
+            }
+            [[fallthrough]];
+        default: // 内容唯一，大小可能与其他文件相同
+            content = pattern.substr(0, 1 + i * 37 % 20000);
+            content.replace(0, std::min(tag.size(), content.size()), tag.substr(0, content.size()));
+        }
+        writeFile(path, content);
+        if (i % 10 == 4 && firstBig.empty()) firstBig = path;
+    }
+    std::cout << "重复文件查找基准测试: " << files << " 个文件" << std::endl;
+
+    // 每个文件整个读出来算哈希，按 (大小, 哈希) 分组
+    std::size_t naiveGroups = 0;
+    std::uint64_t naiveBytes = 0;
+    double sec = secondsOf([&]() {
+        std::unordered_map<std::uint64_t, std::vector<std::string>> byHash;
+        for (const auto& e : fs::recursive_directory_iterator(root)) {
+            if (!e.is_regular_file()) continue;
+            std::ifstream in(e.path(), std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            naiveBytes += content.size();
+            byHash[xxh64(content.data(), content.size()) ^ content.size()].push_back(e.path().string());
+        }
+        for (const auto& [hash, paths] : byHash) naiveGroups += paths.size() > 1;
+    });
+    std::cout << "[全部读取 + 哈希] " << sec * 1e3 << " ms, 读取 " << naiveBytes / 1e6 << " MB, " << naiveGroups
+              << " 组（硬链接也被算作重复）" << std::endl;
+
+    std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> threadCounts{1};
+    if (hw > 1) threadCounts.push_back(hw);
+    DuplicateReport report;
+    for (std::size_t threads : threadCounts) {
+        DuplicateOptions options;
+        options.threads = threads;
+        options.walk.threads = threads;
+        report = findDuplicates(root.string(), options);
+        bool ok = report.groups.size() == 2 && report.hardLinks == links &&
+                  report.groups[0].paths.size() == expectBig && report.groups[1].paths.size() == expectSmall;
+        std::cout << "[findDuplicates x" << threads << "] " << report.seconds * 1e3 << " ms, 读取 "
+                  << report.bytesRead / 1e6 << " MB" << checkMark(ok) << std::endl;
+    }
+    printDuplicateReport(report, std::cout, 0);
+    fs::remove_all(root);
+}
@@ -0,0 +1,272 @@
+#include "fileCopy.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mappedFile.h"
+#include "fileUtil.h"
+
+namespace {
+
+// 这些错误表示当前方式对这对文件不可用（文件系统或内核不支持、跨文件系统），应换下一种方式而不是报错
+bool unsupported(int error) { return error == ENOSYS || error == EOPNOTSUPP || error == EXDEV || error == EINVAL; }
+
+struct Segment {
+    std::uint64_t offset;
+    std::uint64_t length;
+};
+
+// 源文件的数据段（空洞之间的部分），按 chunkSize 切块
+std::vector<Segment> dataChunks(int fd, std::uint64_t size, const CopyOptions& options) {
+    std::vector<Segment> data;
+    bool seekable = options.preserveSparse;
+    for (std::uint64_t pos = 0; seekable && pos < size;) {
+        off_t begin = lseek(fd, static_cast<off_t>(pos), SEEK_DATA);
+        if (begin < 0) {
+            if (errno != ENXIO) seekable = false; // 不支持 SEEK_DATA：整个文件视为数据
+            break;                                // ENXIO：pos 之后全是空洞
+        }
+        if (static_cast<std::uint64_t>(begin) >= size) break; // 文件在 fstat 之后变长：只复制 fstat 时的长度
+        off_t end = lseek(fd, begin, SEEK_HOLE);
+        std::uint64_t stop = end < 0 ? size : std::min<std::uint64_t>(size, static_cast<std::uint64_t>(end));
+        data.push_back({static_cast<std::uint64_t>(begin), stop - static_cast<std::uint64_t>(begin)});
+        pos = stop;
+    }
+    if (!seekable) data.assign(size > 0 ? 1 : 0, Segment{0, size});
+    std::vector<Segment> chunks;
+    const std::uint64_t chunk = std::max<std::size_t>(options.chunkSize, 1 << 20);
+    for (const Segment& s : data)
+        for (std::uint64_t off = 0; off < s.length; off += chunk)
+            chunks.push_back({s.offset + off, std::min(chunk, s.length - off)});
+    return chunks;
+}
+
+class ChunkCopier {
+public:
+    ChunkCopier(int src, const std::string& dst, const CopyOptions& options, CopyMethod first)
+        : src(src), dst(dst), options(options), method(static_cast<int>(first)), used(static_cast<int>(first)) {}
+
+    CopyMethod run(const std::vector<Segment>& chunks) {
+        std::size_t threads = std::clamp<std::size_t>(options.threads, 1, std::max<std::size_t>(1, chunks.size()));
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < threads; ++i) workers.emplace_back([this, &chunks]() { work(chunks); });
+        for (auto& t : workers) t.join();
+        if (failure) std::rethrow_exception(failure);
+        return static_cast<CopyMethod>(used.load());
+    }
+
+private:
+    void work(const std::vector<Segment>& chunks) {
+        try {
+            // sendfile 写入的是目标 fd 的当前偏移，各线程各开一个 fd，互不干扰
+            FdGuard out{open(dst.c_str(), O_WRONLY | O_CLOEXEC)};
+            if (out.fd < 0) throwErrno("copyFile: open " + dst);
+            char* buffer = nullptr;
+            for (std::size_t i = next++; i < chunks.size() && !failed; i = next++)
+                copyChunk(out.fd, chunks[i], buffer);
+            std::free(buffer);
+        } catch (...) {
+            failed = true;
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!failure) failure = std::current_exception();
+        }
+    }
+
+    void copyChunk(int out, const Segment& chunk, char*& buffer) {
+        std::uint64_t pos = chunk.offset;
+        const std::uint64_t end = chunk.offset + chunk.length;
+        while (pos < end) {
+            int m = method.load(std::memory_order_relaxed);
+            std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(end - pos, std::uint64_t(1) << 30));
+            ssize_t n;
+            if (m == static_cast<int>(CopyMethod::CopyFileRange)) {
+                loff_t in = static_cast<loff_t>(pos), outOff = static_cast<loff_t>(pos);
+                n = copy_file_range(src, &in, out, &outOff, want, 0);
+            } else if (m == static_cast<int>(CopyMethod::Sendfile)) {
+                if (lseek(out, static_cast<off_t>(pos), SEEK_SET) < 0) throwErrno("copyFile: lseek");
+                off_t in = static_cast<off_t>(pos);
+                n = sendfile(out, src, &in, want);
+            } else {
+                if (!buffer) {
+                    buffer = static_cast<char*>(std::aligned_alloc(4096, options.bufferSize));
+                    if (!buffer) throw std::bad_alloc();
+                }
+                n = pread(src, buffer, std::min(want, options.bufferSize), static_cast<off_t>(pos));
+                if (n > 0) writeAll(out, buffer, static_cast<std::size_t>(n), pos);
+            }
+            if (n > 0) {
+                pos += static_cast<std::uint64_t>(n);
+                int prev = used.load(std::memory_order_relaxed);
+                while (prev < m && !used.compare_exchange_weak(prev, m)) {}
+                continue;
+            }
+            if (n == 0) return; // 源文件在复制过程中被截短
+            if (errno == EINTR) continue;
+            if (m != static_cast<int>(CopyMethod::ReadWrite) && unsupported(errno)) {
+                method.compare_exchange_strong(m, m + 1); // 降级到下一种方式，从当前位置继续
+                continue;
+            }
+            throwErrno("copyFile: " + std::string(copyMethodName(static_cast<CopyMethod>(m))));
+        }
+    }
+
+    void writeAll(int out, const char* data, std::size_t len, std::uint64_t offset) {
+        while (len > 0) {
+            ssize_t n = pwrite(out, data, len, static_cast<off_t>(offset));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throwErrno("copyFile: pwrite " + dst);
+            }
+            data += n, len -= static_cast<std::size_t>(n), offset += static_cast<std::uint64_t>(n);
+        }
+    }
+
+    int src;
+    const std::string& dst;
+    const CopyOptions& options;
+    std::atomic<int> method; // 当前使用的方式，只会向更慢的方向降级
+    std::atomic<int> used;   // 实际用过的最慢方式
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex mtx;
+    std::exception_ptr failure;
+};
+
+} // namespace
+
+const char* copyMethodName(CopyMethod method) {
+    switch (method) {
+        case CopyMethod::Reflink: return "reflink(FICLONE)";
+        case CopyMethod::CopyFileRange: return "copy_file_range";
+        case CopyMethod::Sendfile: return "sendfile";
+        case CopyMethod::ReadWrite: return "pread/pwrite";
+    }
+    return "unknown";
+}
+
+CopyResult copyFile(const std::string& src, const std::string& dst, const CopyOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    FdGuard in{open(src.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (in.fd < 0) throwErrno("copyFile: open " + src);
+    struct stat st;
+    if (fstat(in.fd, &st) != 0) throwErrno("copyFile: fstat " + src);
+    // 先不截断：src 与 dst 可能是同一个文件（同一路径、硬链接或符号链接），O_TRUNC 会在比较之前把它清空
+    FdGuard out{open(dst.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, st.st_mode & 07777)};
+    if (out.fd < 0) throwErrno("copyFile: open " + dst);
+    struct stat dstSt;
+    if (fstat(out.fd, &dstSt) != 0) throwErrno("copyFile: fstat " + dst);
+    if (dstSt.st_dev == st.st_dev && dstSt.st_ino == st.st_ino) // 与 fs::copy 相同，报告 file_exists
+        throw std::system_error(std::make_error_code(std::errc::file_exists), "copyFile: " + src + " and " + dst +
+                                                                                  " are the same file");
+    if (ftruncate(out.fd, 0) != 0) throwErrno("copyFile: ftruncate " + dst);
+    fchmod(out.fd, st.st_mode & 07777); // 目标已存在时 open 不会修改权限
+
+    CopyResult result;
+    result.bytes = static_cast<std::uint64_t>(st.st_size);
+    auto finish = [&]() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.seconds = elapsed.count();
+        return result;
+    };
+
+    if (options.firstMethod == CopyMethod::Reflink) {
+        if (ioctl(out.fd, FICLONE, in.fd) == 0) {
+            result.method = CopyMethod::Reflink;
+            return finish();
+        }
+    }
+    // 目标先扩展到完整长度（全部是空洞），之后只写数据段
+    if (ftruncate(out.fd, st.st_size) != 0) throwErrno("copyFile: ftruncate " + dst);
+    std::vector<Segment> chunks = dataChunks(in.fd, result.bytes, options);
+    for (const Segment& c : chunks) result.dataBytes += c.length;
+    CopyMethod first = options.firstMethod == CopyMethod::Reflink ? CopyMethod::CopyFileRange : options.firstMethod;
+    result.method = ChunkCopier(in.fd, dst, options, first).run(chunks);
+    return finish();
+}
+
+namespace {
+
+std::uint64_t allocatedBytes(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<std::uint64_t>(st.st_blocks) * 512 : 0;
+}
+
+bool sameContent(const std::string& a, const std::string& b) {
+    MappedFile x(a, MapMode::ReadOnly, AccessHint::Sequential), y(b, MapMode::ReadOnly, AccessHint::Sequential);
+    return x.size() == y.size() && (x.empty() || std::memcmp(x.data(), y.data(), x.size()) == 0);
+}
+
+} // namespace
+
+void benchFileCopy(const std::string& dir, std::size_t bytes) {
+    namespace fs = std::filesystem;
+    const std::string src = (fs::path(dir) / "copy_src.bin").string();
+    const std::string dst = (fs::path(dir) / "copy_dst.bin").string();
+    {
+        // 每 64 MB 交替为数据与空洞，最后以空洞结尾
+        FdGuard fd{open(src.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+        if (fd.fd < 0) throwErrno("benchFileCopy: create " + src);
+        const std::size_t extent = std::size_t(64) << 20;
+        std::vector<char> block(std::size_t(1) << 20);
+        for (std::size_t off = 0; off < bytes; off += 2 * extent)
+            for (std::size_t b = off; b < std::min(bytes, off + extent); b += block.size()) {
+                for (std::size_t i = 0; i < block.size(); i += 8) std::memcpy(block.data() + i, &b, sizeof(b));
+                if (pwrite(fd.fd, block.data(), std::min(block.size(), bytes - b), static_cast<off_t>(b)) < 0)
+                    throwErrno("benchFileCopy: write");
+            }
+        if (ftruncate(fd.fd, static_cast<off_t>(bytes)) != 0) throwErrno("benchFileCopy: ftruncate");
+        fsync(fd.fd);
+    }
+    std::cout << "文件复制基准测试: " << src << ", " << (bytes >> 20) << " MB, 实际占用 " << (allocatedBytes(src) >> 20)
+              << " MB（数据在页缓存中，目标不做 fsync）" << std::endl;
+
+    auto report = [&](const std::string& name, double seconds, const char* method) {
+        std::cout << "[" << name << "] " << method << ", " << bytes / seconds / 1e9 << " GB/s, 目标占用 "
+                  << (allocatedBytes(dst) >> 20) << " MB" << checkMark(sameContent(src, dst)) << std::endl;
+        fs::remove(dst);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    fs::copy(src, dst, fs::copy_options::overwrite_existing);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    report("fs::copy", elapsed.count(), "libstdc++");
+
+    const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    struct Case {
+        const char* name;
+        CopyMethod first;
+        std::size_t threads;
+        bool sparse;
+    };
+    const Case cases[] = {
+        {"copyFile 自动", CopyMethod::Reflink, hw, true},
+        {"copyFile 从 copy_file_range 开始", CopyMethod::CopyFileRange, hw, true},
+        {"copyFile 从 sendfile 开始", CopyMethod::Sendfile, hw, true},
+        {"copyFile pread/pwrite", CopyMethod::ReadWrite, 1, true},
+        {"copyFile pread/pwrite", CopyMethod::ReadWrite, std::max<std::size_t>(4, hw), true},
+        {"copyFile pread/pwrite 不保留空洞", CopyMethod::ReadWrite, std::max<std::size_t>(4, hw), false},
+    };
+    for (const Case& c : cases) {
+        CopyOptions options;
+        options.firstMethod = c.first;
+        options.threads = c.threads;
+        options.preserveSparse = c.sparse;
+        CopyResult r = copyFile(src, dst, options);
+        report(c.name + std::string(" (") + std::to_string(c.threads) + " 线程)", r.seconds, copyMethodName(r.method));
+    }
+    fs::remove(src);
+}
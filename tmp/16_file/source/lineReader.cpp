@@ -0,0 +1,172 @@
+#include "lineReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <fcntl.h>
+#include <immintrin.h>
+#include <unistd.h>
+#include "mappedFile.h"
+#include "fileUtil.h"
+
+namespace {
+
+std::uint64_t newlineMaskSse2(const char* p) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)))) << (16 * i);
+    }
+    return mask;
+}
+
+__attribute__((target("avx2"))) std::uint64_t newlineMaskAvx2(const char* p) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    std::uint32_t a = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, nl)));
+    std::uint32_t b = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, nl)));
+    return static_cast<std::uint64_t>(b) << 32 | a;
+}
+
+using MaskFn = std::uint64_t (*)(const char*);
+
+MaskFn selectMaskFn() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? newlineMaskAvx2 : newlineMaskSse2;
+}
+
+const MaskFn maskFn = selectMaskFn();
+
+} // namespace
+
+std::uint64_t newlineMask64(const char* p) { return maskFn(p); }
+
+const char* newlineMaskIsa() { return maskFn == newlineMaskAvx2 ? "AVX2" : "SSE2"; }
+
+LineReader::LineReader(const std::string& path, std::size_t bufferSize)
+    : fd(open(path.c_str(), O_RDONLY | O_CLOEXEC)), ownsFd(true), buffer(std::max<std::size_t>(bufferSize, 64)) {
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "LineReader: open " + path);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+LineReader::LineReader(int fd, std::size_t bufferSize) : fd(fd), buffer(std::max<std::size_t>(bufferSize, 64)) {}
+
+LineReader::~LineReader() {
+    if (ownsFd) close(fd);
+}
+
+bool LineReader::next(std::string_view& line) {
+    for (;;) {
+        if (splitter.nextTerminated(line)) return true;
+        if (eof) {
+            line = splitter.rest();
+            splitter = LineSplitter();
+            return !line.empty();
+        }
+        refill();
+    }
+}
+
+// 把残行移到缓冲区开头，再读入新数据；残行占满缓冲区（单行超长）时缓冲区加倍
+bool LineReader::refill() {
+    std::string_view rest = splitter.rest();
+    std::size_t keep = rest.size();
+    if (keep > 0 && rest.data() != buffer.data()) std::memmove(buffer.data(), rest.data(), keep);
+    if (keep == buffer.size()) buffer.resize(buffer.size() * 2);
+    filled = keep;
+    ssize_t n;
+    do {
+        n = read(fd, buffer.data() + filled, buffer.size() - filled);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) throw std::system_error(errno, std::generic_category(), "LineReader: read");
+    if (n == 0) eof = true;
+    filled += static_cast<std::size_t>(n);
+    splitter = LineSplitter(std::string_view(buffer.data(), filled), keep);
+    return n > 0;
+}
+
+namespace {
+
+struct LineStats {
+    std::size_t lines = 0;
+    std::size_t chars = 0; // 不含换行的字符总数，用来确认各方法切出的行完全相同
+    bool operator==(const LineStats& o) const { return lines == o.lines && chars == o.chars; }
+};
+
+} // namespace
+
+void benchLineSplit(const std::string& path, std::size_t bytes) {
+    {
+        // 生成类似日志的文件：行长 20~200 字节，偶尔有空行，最后一行不带换行
+        std::ofstream out(path, std::ios::binary);
+        std::string line;
+        std::uint32_t x = 2463534242u;
+        std::size_t written = 0;
+        while (written < bytes) {
+            x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+            std::size_t len = x % 16 == 0 ? 0 : 20 + x % 181;
+            line.assign(len, static_cast<char>('a' + x % 26));
+            line += '\n';
+            out << line;
+            written += line.size();
+        }
+        out << "no trailing newline";
+    }
+    std::cout << "按行读取基准测试: " << path << ", " << (bytes >> 20) << " MB, 换行查找: " << newlineMaskIsa() << std::endl;
+    auto report = [&](const char* name, double sec, const LineStats& s, const LineStats& expected) {
+        std::cout << name << ": " << s.lines << " 行, " << bytes / sec / 1e9 << " GB/s" << checkMark(s == expected)
+                  << std::endl;
+    };
+
+    LineStats expected;
+    double sec = secondsOf([&]() {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line)) ++expected.lines, expected.chars += line.size();
+    });
+    report("[ifstream + getline]", sec, expected, expected);
+
+    MappedFile file(path, MapMode::ReadOnly, AccessHint::Sequential);
+    LineStats s;
+    sec = secondsOf([&]() {
+        std::string_view text = file.view();
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* lineEnd = nl ? nl : end;
+            ++s.lines, s.chars += lineEnd - p;
+            p = lineEnd + 1;
+        }
+    });
+    report("[MappedFile + memchr]", sec, s, expected);
+
+    s = LineStats();
+    sec = secondsOf([&]() {
+        for (std::string_view line : Lines(file.view())) ++s.lines, s.chars += line.size();
+    });
+    report("[MappedFile + Lines]", sec, s, expected);
+
+    s = LineStats();
+    sec = secondsOf([&]() {
+        LineReader reader(path);
+        std::string_view line;
+        while (reader.next(line)) ++s.lines, s.chars += line.size();
+    });
+    report("[LineReader 流式 1MB 缓冲]", sec, s, expected);
+
+    s = LineStats();
+    sec = secondsOf([&]() {
+        LineReader reader(path, 64); // 极小的缓冲区：几乎每行都跨越缓冲区边界，并且多次加倍
+        std::string_view line;
+        while (reader.next(line)) ++s.lines, s.chars += line.size();
+    });
+    report("[LineReader 流式 64B 初始缓冲]", sec, s, expected);
+    std::remove(path.c_str());
+}
@@ -162,6 +162,25 @@ void displayList(const fs::path& dir,int id = 0){
     }
 }
 
+//并行实现：getdents64 + d_type，不对每个条目 stat；多线程读取不同目录，跳过 .git 子树，输出顺序不确定
+#include <cstring>
+#include <mutex>
+#include "dirWalker.h"
+void parallelList(const fs::path& dir) {
+    std::mutex outMtx;
+    WalkOptions options;
+    options.filter = [](const DirEntry& e) { return e.name == ".git" ? WalkFilter::Prune : WalkFilter::Accept; };
+    options.onError = [&](std::string_view path, int error) {
+        std::lock_guard<std::mutex> lock(outMtx);
+        std::cerr << "无法读取目录 " << path << ": " << std::strerror(error) << "\n";
+    };
+    WalkStats stats = parallelWalk(dir.string(), [&](const DirEntry& e) {
+        std::lock_guard<std::mutex> lock(outMtx);
+        std::cout << std::string(2 * (e.depth - 1), '-') << e.name << (e.type == EntryType::Directory ? "/" : "") << "\n";
+    }, options);
+    std::cout << "共 " << stats.entries << " 个条目, " << stats.directories << " 个目录\n";
+}
+
 //3.错误处理
 void handlerError(){
     try {
@@ -253,10 +272,139 @@ void testlink(){
     
 }
 
+//5. 内存映射读取：不经过流缓冲区，直接以 string_view 访问页缓存中的文件内容
+#include "mappedFile.h"
+void mappedRead(const fs::path& file){
+    MappedFile mapped(file.string(), MapMode::ReadOnly, AccessHint::Sequential);
+    std::cout << "文件大小: " << mapped.size() << " 字节\n" << mapped.view();
+}
+
+//6. 零复制按行读取：对比 testlink 中的 getline，行以 string_view 指向映射的文件，不复制、不分配
+#include "lineReader.h"
+void mappedLines(const fs::path& file){
+    MappedFile mapped(file.string(), MapMode::ReadOnly, AccessHint::Sequential);
+    for (std::string_view line : Lines(mapped.view())) {
+        std::cout << line << std::endl;
+    }
+}
+
+//7. 异步读取：一个线程同时发起多个读请求，完成时在 wait() 中执行回调（io_uring，不可用时线程池 + epoll）
+#include "asyncIo.h"
+#include <fcntl.h>
+#include <unistd.h>
+void asyncRead(const fs::path& file){
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "无法打开文件: " << file << std::endl;
+        return;
+    }
+    AsyncIo io(8);
+    char head[16] = {}, tail[16] = {};
+    std::future<int> first = io.read(IoFile::fd(fd), head, sizeof(head) - 1, 0);
+    io.read(IoFile::fd(fd), tail, sizeof(tail) - 1, 16, [&](int n) {
+        std::cout << "回调: 偏移 16 处读到 " << n << " 字节: " << tail << "\n";
+    });
+    io.submit(); // 两个请求一次提交
+    io.wait();
+    std::cout << ioBackendName(io.backend()) << ": 偏移 0 处读到 " << first.get() << " 字节: " << head << "\n";
+    close(fd);
+}
+
+//8. 大文件复制：reflink -> copy_file_range -> sendfile -> 并行 pread/pwrite，保留稀疏文件的空洞
+#include "fileCopy.h"
+void bigCopy(const fs::path& src, const fs::path& dst){
+    CopyResult r = copyFile(src.string(), dst.string());
+    std::cout << copyMethodName(r.method) << ": " << r.bytes << " 字节（数据 " << r.dataBytes << " 字节）, "
+              << r.seconds << " 秒, " << r.throughput() << " GB/s\n";
+}
+
+//9. 追加写日志：对比 testlink 第 4 步的 ofstream(app) + endl，攒满缓冲区再用 writev 一次写出
+#include "appendWriter.h"
+void appendLog(const fs::path& file){
+    AppendWriter writer(file.string());
+    for (int i = 0; i < 3; ++i) {
+        writer.appendLine("追加的一行文本 " + std::to_string(i));
+    }
+    writer.sync(); // 需要落盘保证时调用，多线程同时调用时合并为一次 fdatasync
+}
+
+//10. 元数据缓存：反复查询同一批路径时从内存返回，文件变化由 inotify 增量作废
+#include "metadataCache.h"
+void cachedStatus(const fs::path& dir){
+    MetadataCache cache;
+    for (int round = 0; round < 2; ++round) { // 第二轮全部命中，没有系统调用
+        for (const auto& e : *cache.list(dir.string())) {
+            FileMeta m = cache.status((dir / e.name).string());
+            std::cout << e.name << (m.type == EntryType::Directory ? "/" : "") << " " << m.size << " 字节\n";
+        }
+    }
+    MetadataCacheStats s = cache.stats();
+    std::cout << "命中 " << s.hits << " 次, 未命中 " << s.misses << " 次\n";
+}
+
+//11. 批量取元数据：statx 只取需要的字段，多线程 / io_uring 并行，结果按列存放
+#include "bulkStat.h"
+void inventory(const fs::path& dir){
+    BulkStatOptions options;
+    options.fields = StatType | StatMode | StatSize;
+    StatTable t = bulkStatTree(dir.string(), options);
+    std::uint64_t bytes = 0, writable = 0;
+    for (std::size_t i = 0; i < t.count(); ++i) { // 按列遍历，与 normalOperation 的 permissions() 检查相同
+        if (t.error[i] || t.type[i] != EntryType::File) continue;
+        bytes += t.size[i];
+        if (t.mode[i] & 0200) ++writable;
+    }
+    std::cout << t.count() << " 个条目（" << statBackendName(t.backend) << "）, 文件共 " << bytes << " 字节, "
+              << writable << " 个文件属主可写\n";
+}
+
+//12. 重复文件查找：按大小 -> 头尾 4KB 的哈希 -> 完整哈希 -> 逐字节比较逐级筛选，多线程流水线执行
+#include "dupFinder.h"
+void findDuplicateFiles(const fs::path& dir){
+    DuplicateOptions options;
+    options.walk.filter = [](const DirEntry& e) {
+        return e.type == EntryType::Directory && e.name == ".git" ? WalkFilter::Prune : WalkFilter::Accept;
+    };
+    printDuplicateReport(findDuplicates(dir.string(), options), std::cout);
+}
+
+//13. 直接 I/O：O_DIRECT 绕过页缓存顺序扫描大文件，双缓冲预读，不支持时自动退回普通读取
+#include <algorithm>
+#include "directFile.h"
+void directScan(const fs::path& file){
+    DirectReader reader(file.string());
+    std::uint64_t lines = 0;
+    std::span<const std::byte> block;
+    while (reader.next(block)) {
+        lines += std::count(block.begin(), block.end(), std::byte('\n'));
+    }
+    std::cout << (reader.direct() ? "O_DIRECT" : "普通读取") << ": " << reader.size() << " 字节, " << lines << " 行\n";
+}
+
 int main(){
     //normalOperation();
     //recursiveList("/home/gamma/cppStudy/16_file");
     //displayList("/home/gamma/cppStudy/16_file");
+    //parallelList("/home/gamma/cppStudy/16_file");
+    //benchDirWalk("/usr");
+    //mappedRead("target.txt");
+    //benchMappedFile("mapped_bench.bin");
+    //mappedLines("target.txt");
+    //benchLineSplit("lines_bench.log");
+    //asyncRead("target.txt");
+    //benchAsyncIo("async_bench.bin");
+    //bigCopy("target.txt", "target_copy.txt");
+    //benchFileCopy(".");
+    //appendLog("target.txt");
+    //benchAppendWriter("append_bench.log");
+    //cachedStatus(".");
+    //benchMetadataCache(".");
+    //inventory(".");
+    //benchBulkStat(".");
+    //findDuplicateFiles("/home/gamma/cppStudy");
+    //benchDuplicateFinder(".");
+    //directScan("target.txt");
+    //benchDirectIo("direct_bench.bin");
     testlink();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "mappedFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "fileUtil.h"
+
+namespace {
+
+int adviceOf(AccessHint hint) {
+    switch (hint) {
+        case AccessHint::Sequential: return MADV_SEQUENTIAL;
+        case AccessHint::Random: return MADV_RANDOM;
+        case AccessHint::WillNeed: return MADV_WILLNEED;
+        default: return MADV_NORMAL;
+    }
+}
+
+} // namespace
+
+const char* accessHintName(AccessHint hint) {
+    switch (hint) {
+        case AccessHint::Normal: return "Normal";
+        case AccessHint::Sequential: return "Sequential";
+        case AccessHint::Random: return "Random";
+        case AccessHint::WillNeed: return "WillNeed";
+    }
+    return "unknown";
+}
+
+MappedFile::MappedFile(const std::string& path, MapMode mode, AccessHint hint, std::size_t size) : mode(mode) {
+    const bool rw = mode == MapMode::ReadWrite;
+    int fd = open(path.c_str(), rw ? (O_RDWR | O_CREAT | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC), 0644);
+    if (fd < 0) throwErrno("MappedFile: open " + path);
+    FdGuard closer{fd};
+
+    if (rw && size != KEEP_SIZE) {
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) throwErrno("MappedFile: ftruncate " + path);
+        length = size;
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0) throwErrno("MappedFile: fstat " + path);
+        length = static_cast<std::size_t>(st.st_size);
+    }
+    if (length == 0) return;
+
+    int prot = rw ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* p = mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        length = 0;
+        throwErrno("MappedFile: mmap " + path);
+    }
+    ptr = static_cast<std::byte*>(p);
+    if (hint != AccessHint::Normal) advise(hint);
+}
+
+MappedFile::~MappedFile() { release(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : ptr(std::exchange(other.ptr, nullptr)), length(std::exchange(other.length, 0)), mode(other.mode) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        ptr = std::exchange(other.ptr, nullptr);
+        length = std::exchange(other.length, 0);
+        mode = other.mode;
+    }
+    return *this;
+}
+
+void MappedFile::release() noexcept {
+    if (ptr) munmap(ptr, length);
+    ptr = nullptr;
+    length = 0;
+}
+
+std::span<std::byte> MappedFile::writableBytes() {
+    if (!writable()) throw std::logic_error("MappedFile: mapping is read-only");
+    return {ptr, length};
+}
+
+void MappedFile::advise(AccessHint hint, std::size_t offset, std::size_t len) {
+    if (!ptr || offset >= length) return;
+    len = std::min(len, length - offset);
+    // madvise 要求起始地址按页对齐：向前扩展到页边界（映射起点本身是页对齐的）
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t begin = offset / page * page;
+    if (madvise(ptr + begin, len + (offset - begin), adviceOf(hint)) != 0) throwErrno("MappedFile: madvise");
+}
+
+void MappedFile::sync(bool async) {
+    if (!ptr || !writable()) return;
+    if (msync(ptr, length, async ? MS_ASYNC : MS_SYNC) != 0) throwErrno("MappedFile: msync");
+}
+
+namespace {
+
+// 按 8 字节异或做校验，保证每个字节都被读到且编译器不能省掉读取
+std::uint64_t checksum(const std::byte* p, std::size_t n) {
+    std::uint64_t acc = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        acc ^= word;
+    }
+    for (; i < n; ++i) acc ^= static_cast<std::uint64_t>(p[i]) << (i % 8 * 8);
+    return acc;
+}
+
+} // namespace
+
+void benchMappedFile(const std::string& path, std::size_t bytes) {
+    constexpr std::size_t CHUNK = std::size_t(1) << 20;
+    constexpr std::size_t LOOKUP = 4096;
+    {
+        // 生成测试文件：用 MappedFile 的读写模式直接写入
+        MappedFile out(path, MapMode::ReadWrite, AccessHint::Sequential, bytes);
+        auto span = out.writableBytes();
+        std::uint64_t x = 0x9e3779b97f4a7c15ull;
+        for (std::size_t i = 0; i + 8 <= span.size(); i += 8) {
+            x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+            std::memcpy(span.data() + i, &x, 8);
+        }
+    }
+    std::cout << "内存映射基准测试: " << path << ", " << (bytes >> 20) << " MB（文件已在页缓存中）" << std::endl;
+
+    std::uint64_t expected = 0, got = 0;
+    std::vector<char> buffer(CHUNK);
+    double sec = secondsOf([&]() {
+        std::ifstream in(path, std::ios::binary);
+        while (in.read(buffer.data(), CHUNK) || in.gcount() > 0)
+            expected ^= checksum(reinterpret_cast<const std::byte*>(buffer.data()), static_cast<std::size_t>(in.gcount()));
+    });
+    std::cout << "[ifstream::read 1MB 顺序扫描] " << bytes / sec / 1e9 << " GB/s" << std::endl;
+
+    for (AccessHint hint : {AccessHint::Normal, AccessHint::Sequential, AccessHint::WillNeed}) {
+        got = 0;
+        sec = secondsOf([&]() {
+            MappedFile file(path, MapMode::ReadOnly, hint);
+            auto data = file.bytes();
+            for (std::size_t off = 0; off < data.size(); off += CHUNK)
+                got ^= checksum(data.data() + off, std::min(CHUNK, data.size() - off));
+        });
+        std::cout << "[MappedFile " << accessHintName(hint) << " 顺序扫描] " << bytes / sec / 1e9 << " GB/s"
+                  << checkMark(got == expected) << std::endl;
+    }
+
+    if (bytes < LOOKUP) {
+        std::cout << "[随机 4KB] 跳过：文件不足 " << LOOKUP << " 字节" << std::endl;
+        std::remove(path.c_str());
+        return;
+    }
+
+    // 随机 4KB 读取：两种方式使用相同的偏移序列
+    const std::size_t lookups = 200000;
+    std::vector<std::size_t> offsets(lookups);
+    std::mt19937_64 rng(42);
+    for (auto& off : offsets) off = rng() % (bytes / LOOKUP) * LOOKUP;
+    expected = 0;
+    sec = secondsOf([&]() {
+        std::ifstream in(path, std::ios::binary);
+        for (std::size_t off : offsets) {
+            in.seekg(static_cast<std::streamoff>(off));
+            in.read(buffer.data(), LOOKUP);
+            expected ^= checksum(reinterpret_cast<const std::byte*>(buffer.data()), LOOKUP);
+        }
+    });
+    std::cout << "[ifstream seekg+read 随机 4KB] " << sec * 1e6 / lookups << " us/次" << std::endl;
+    got = 0;
+    sec = secondsOf([&]() {
+        MappedFile file(path, MapMode::ReadOnly, AccessHint::Random);
+        for (std::size_t off : offsets) got ^= checksum(file.data() + off, LOOKUP);
+    });
+    std::cout << "[MappedFile Random 随机 4KB] " << sec * 1e6 / lookups << " us/次"
+              << checkMark(got == expected) << std::endl;
+    std::remove(path.c_str());
+}
@@ -0,0 +1,376 @@
+#include "metadataCache.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <system_error>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "fileUtil.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB |
+                                     IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+// 这些事件会改变目录的内容列表（以及目录自身的 mtime）
+constexpr std::uint32_t LISTING_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+FileMeta metaOf(const struct stat& st) {
+    FileMeta m;
+    m.exists = true;
+    m.type = typeFromMode(st.st_mode);
+    m.size = static_cast<std::uint64_t>(st.st_size);
+    m.mode = st.st_mode;
+    m.mtimeNs = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return m;
+}
+
+std::string parentOf(const std::string& path) {
+    std::size_t slash = path.rfind('/');
+    return slash == 0 || slash == std::string::npos ? std::string("/") : path.substr(0, slash);
+}
+
+std::string childOf(const std::string& dir, const char* name) { return dir == "/" ? "/" + std::string(name) : dir + "/" + name; }
+
+struct LinuxDirent64 {
+    std::uint64_t d_ino;
+    std::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// open + getdents64 + close，syscalls 累加实际发出的系统调用次数；失败返回 false
+bool readDirectory(const std::string& dir, std::vector<ListEntry>& out, std::uint64_t& syscalls) {
+    ++syscalls;
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    alignas(8) char buf[32 * 1024];
+    for (;;) {
+        ++syscalls;
+        long n = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        for (long off = 0; off < n;) {
+            auto* d = reinterpret_cast<const LinuxDirent64*>(buf + off);
+            off += d->d_reclen;
+            const char* name = d->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+            EntryType type = EntryType::Other;
+            if (d->d_type == DT_UNKNOWN) {
+                struct stat st;
+                ++syscalls;
+                if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0) type = typeFromMode(st.st_mode);
+            } else {
+                type = typeFromDirent(d->d_type);
+            }
+            out.push_back(ListEntry{name, type});
+        }
+    }
+    ++syscalls;
+    close(fd);
+    return true;
+}
+
+} // namespace
+
+MetadataCache::MetadataCache() : cwd(fs::current_path().string()) {
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) throw std::system_error(errno, std::generic_category(), "MetadataCache: inotify_init1");
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        close(inotifyFd);
+        throw std::system_error(errno, std::generic_category(), "MetadataCache: eventfd");
+    }
+    worker = std::thread([this]() { eventLoop(); });
+}
+
+MetadataCache::~MetadataCache() {
+    std::uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+    worker.join();
+    close(wakeFd);
+    close(inotifyFd);
+}
+
+std::string MetadataCache::normalize(const std::string& path) const {
+    fs::path p(path);
+    if (p.is_relative()) p = fs::path(cwd) / p;
+    std::string s = p.lexically_normal().string();
+    while (s.size() > 1 && s.back() == '/') s.pop_back();
+    return s;
+}
+
+std::int64_t MetadataCache::watchDir(const std::string& dir) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = generations.find(dir);
+        if (it != generations.end() && dirToWd.count(dir)) return it->second;
+    }
+    // 先监视各级上级目录：其中任何一级被改名或删除时，它的父目录会收到事件，据此作废整棵子树
+    if (dir != "/" && watchDir(parentOf(dir)) < 0) return -1;
+    ++syscalls;
+    int wd = inotify_add_watch(inotifyFd, dir.c_str(), WATCH_MASK);
+    if (wd < 0) return -1;
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto& dirs = wdToDirs[wd]; // 同一目录经别的路径已经监视过时，内核返回同一个 wd
+    if (std::find(dirs.begin(), dirs.end(), dir) == dirs.end()) dirs.push_back(dir);
+    dirToWd[dir] = wd;
+    return generations[dir];
+}
+
+bool MetadataCache::stillCurrent(const std::string& dir, std::int64_t generation) const {
+    auto it = generations.find(dir);
+    return it != generations.end() && it->second == generation && dirToWd.count(dir);
+}
+
+FileMeta MetadataCache::status(const std::string& path) {
+    const std::string key = normalize(path);
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            ++hits;
+            return it->second;
+        }
+    }
+    ++misses;
+    const std::string dir = parentOf(key);
+    std::int64_t generation = watchDir(dir); // 先监视再 stat：stat 之后的变化一定会产生事件
+    struct stat st;
+    FileMeta meta;
+    ++syscalls;
+    if (lstat(key.c_str(), &st) == 0) {
+        if (S_ISLNK(st.st_mode)) { // 符号链接：跟随到目标，不缓存
+            ++syscalls;
+            return stat(key.c_str(), &st) == 0 ? metaOf(st) : FileMeta();
+        }
+        meta = metaOf(st);
+    } else if (errno != ENOENT && errno != ENOTDIR) {
+        return meta; // 权限不足等：如实返回不存在，但不缓存
+    }
+    if (generation >= 0) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        if (stillCurrent(dir, generation)) entries[key] = meta;
+    }
+    return meta;
+}
+
+bool MetadataCache::exists(const std::string& path) { return status(path).exists; }
+
+DirListing MetadataCache::list(const std::string& dir) {
+    const std::string key = normalize(dir);
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = listings.find(key);
+        if (it != listings.end()) {
+            ++hits;
+            return it->second;
+        }
+    }
+    ++misses;
+    std::int64_t generation = watchDir(key);
+    auto items = std::make_shared<std::vector<ListEntry>>();
+    std::uint64_t calls = 0;
+    bool ok = readDirectory(key, *items, calls);
+    syscalls += calls;
+    if (ok && generation >= 0) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        if (stillCurrent(key, generation)) listings[key] = items;
+    }
+    return items;
+}
+
+MetadataCacheStats MetadataCache::stats() const {
+    MetadataCacheStats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.invalidations = invalidations;
+    s.events = events;
+    s.syscalls = syscalls;
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    s.watches = dirToWd.size();
+    return s;
+}
+
+// 以下函数调用时持有锁（watchedUnder 共享锁即可，其余需要写锁）
+bool MetadataCache::watchedUnder(const std::string& path) const {
+    if (dirToWd.count(path)) return true;
+    const std::string prefix = path == "/" ? path : path + "/";
+    auto it = dirToWd.lower_bound(prefix);
+    return it != dirToWd.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+}
+
+void MetadataCache::unwatch(const std::string& dir) {
+    auto d = dirToWd.find(dir);
+    if (d == dirToWd.end()) return;
+    const int wd = d->second;
+    dirToWd.erase(d);
+    auto w = wdToDirs.find(wd);
+    if (w == wdToDirs.end()) return;
+    w->second.erase(std::remove(w->second.begin(), w->second.end(), dir), w->second.end());
+    if (w->second.empty()) { // 没有别的路径再用这个监视
+        wdToDirs.erase(w);
+        ++syscalls;
+        inotify_rm_watch(inotifyFd, wd);
+    }
+}
+
+void MetadataCache::invalidateChild(const std::string& dir, const std::string& name) {
+    invalidations += entries.erase(childOf(dir, name.c_str()));
+    ++generations[dir];
+}
+
+// dir 及其下的全部条目、列表与监视都作废：dir 已经不在原来的位置，下次访问时按新的路径解析重新监视
+void MetadataCache::invalidateDir(const std::string& dir) {
+    const std::string prefix = dir == "/" ? dir : dir + "/";
+    auto under = [&](const std::string& key) { return key == dir || key.compare(0, prefix.size(), prefix) == 0; };
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (under(it->first)) {
+            it = entries.erase(it);
+            ++invalidations;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = listings.begin(); it != listings.end();) {
+        if (under(it->first)) it = listings.erase(it);
+        else ++it;
+    }
+    generations.try_emplace(dir, 0);
+    for (auto& g : generations)
+        if (under(g.first)) ++g.second; // 正在 stat 的查询不会再把结果放进缓存
+    std::vector<std::string> watched;
+    for (const auto& d : dirToWd)
+        if (under(d.first)) watched.push_back(d.first);
+    for (const auto& d : watched) unwatch(d);
+}
+
+void MetadataCache::eventLoop() {
+    alignas(inotify_event) char buf[64 * 1024];
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    for (;;) {
+        ++syscalls;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents & POLLIN) return;
+        ++syscalls;
+        ssize_t n = read(inotifyFd, buf, sizeof(buf));
+        if (n <= 0) continue;
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        for (ssize_t off = 0; off < n;) {
+            auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+            off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+            ++events;
+            if (ev->mask & IN_Q_OVERFLOW) { // 丢失了事件，无法知道哪些条目过期
+                invalidations += entries.size();
+                entries.clear();
+                listings.clear();
+                for (auto& g : generations) ++g.second;
+                continue;
+            }
+            auto it = wdToDirs.find(ev->wd);
+            if (it == wdToDirs.end()) continue;
+            const std::vector<std::string> dirs = it->second; // invalidateDir 可能修改 wdToDirs
+            if (ev->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // 目录被删除或移走（监视随之失效）：作废其下所有条目并取消监视，下次访问时重新监视
+                for (const auto& dir : dirs) invalidateDir(dir);
+                continue;
+            }
+            if (ev->len == 0) continue; // 目录自身的属性变化，其状态缓存在父目录的监视下
+            for (const auto& dir : dirs) {
+                invalidateChild(dir, ev->name);
+                if (ev->mask & LISTING_MASK) {
+                    listings.erase(dir);
+                    invalidations += entries.erase(dir); // 目录的 mtime 变了，但父目录不会收到事件
+                    // 子目录（或指向目录的符号链接）被删除、改名或替换：其下缓存的路径现在解析到别处或不存在
+                    const std::string child = childOf(dir, ev->name);
+                    if (watchedUnder(child)) invalidateDir(child);
+                }
+            }
+        }
+    }
+}
+
+void benchMetadataCache(const std::string& dir, std::size_t files, std::size_t rounds) {
+    const std::string root = (fs::path(dir) / "meta_cache_bench").string();
+    fs::remove_all(root);
+    fs::create_directories(root);
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < files; ++i) {
+        paths.push_back(root + "/file" + std::to_string(i) + ".txt");
+        std::ofstream(paths.back()) << i;
+    }
+    std::cout << "元数据缓存基准测试: " << files << " 个文件, " << rounds << " 轮（每轮: 列目录 + 每个文件 exists + status）"
+              << std::endl;
+
+    // 每轮的工作负载：与 displayList + normalOperation 类似
+    std::uint64_t checksum = 0;
+    double sec = secondsOf([&]() {
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const auto& e : fs::directory_iterator(root)) checksum += e.path().filename().string().size();
+            for (const auto& p : paths)
+                if (fs::exists(p)) checksum += fs::status(p).permissions() == fs::perms::none ? 0 : 1;
+        }
+    });
+    std::cout << "[std::filesystem] 耗时: " << sec * 1e3 << " ms" << std::endl;
+
+    // 同样的负载直接用系统调用，精确计数
+    std::uint64_t direct = 0, directSum = 0;
+    sec = secondsOf([&]() {
+        for (std::size_t r = 0; r < rounds; ++r) {
+            std::vector<ListEntry> items;
+            readDirectory(root, items, direct);
+            for (const auto& e : items) directSum += e.name.size();
+            for (const auto& p : paths) {
+                struct stat st;
+                direct += 2;
+                if (stat(p.c_str(), &st) == 0 && stat(p.c_str(), &st) == 0) directSum += (st.st_mode & 07777) ? 1 : 0;
+            }
+        }
+    });
+    std::cout << "[直接系统调用] 耗时: " << sec * 1e3 << " ms, 系统调用: " << direct << " 次" << std::endl;
+
+    MetadataCache cache;
+    std::uint64_t cachedSum = 0;
+    sec = secondsOf([&]() {
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const auto& e : *cache.list(root)) cachedSum += e.name.size();
+            for (const auto& p : paths)
+                if (cache.exists(p)) cachedSum += (cache.status(p).mode & 07777) ? 1 : 0;
+        }
+    });
+    MetadataCacheStats s = cache.stats();
+    std::cout << "[MetadataCache] 耗时: " << sec * 1e3 << " ms, 系统调用: " << s.syscalls << " 次, 命中 " << s.hits
+              << " / 未命中 " << s.misses << ", 监视目录 " << s.watches
+              << checkMark(cachedSum == directSum && checksum == directSum) << std::endl;
+
+    // 增量失效：修改一个文件、新建一个文件，只有相关条目被作废
+    std::ofstream(paths[0], std::ios::app) << "more data";
+    std::ofstream(root + "/new.txt") << "new";
+    FileMeta updated;
+    bool seen = false;
+    for (int i = 0; i < 1000 && !seen; ++i) { // inotify 是异步的，等后台线程处理完事件
+        updated = cache.status(paths[0]);
+        seen = updated.size == fs::file_size(paths[0]) && cache.exists(root + "/new.txt");
+        if (!seen) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    s = cache.stats();
+    std::cout << "[增量失效] 修改与新建文件后: " << (seen ? "缓存已更新" : "(校验失败!) 缓存未更新") << ", 事件 " << s.events
+              << " 个, 作废条目 " << s.invalidations << " 个, 列表条目数 " << cache.list(root)->size() << std::endl;
+    fs::remove_all(root);
+}
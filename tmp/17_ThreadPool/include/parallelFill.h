@@ -0,0 +1,102 @@
+#ifndef __PARALLELFILL__H__
+#define __PARALLELFILL__H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "threadPool.h"
+
+/*
+并行初始化与“首次访问（first-touch）”内存放置
+    std::vector<int> data(dataSize) 会在构造时把所有元素置 0，随后 main 里又串行写一遍：
+        1. 数据量很大时（例如 10 GB），单线程初始化本身就比后面的并行计算还慢；
+        2. Linux 默认按“首次访问”分配物理页：哪个线程第一次写某一页，这一页就分配在该线程所在 CPU 的 NUMA 节点上。
+           主线程把所有页都写了一遍，所有数据都落在主线程的节点上，之后各工作线程都要去访问同一个节点的内存控制器，
+           远端节点的线程还要跨节点访问。
+    做法：
+        1. DefaultInitAllocator：让 vector 的 resize/构造只做默认初始化（对 int 就是什么都不写），只分配虚拟地址，不触碰物理页；
+        2. parallelGenerate / parallelFill：把数组切成与线程数相同的块，块边界按地址对齐到页，由线程池中的线程各自写自己的块，
+           物理页就分散在各工作线程所在的节点上，之后用 parallelForPages 以同样的切分做并行计算时，访问大多落在本地节点，
+           各节点的内存带宽也能同时用上。
+    注意：ThreadPool 不把任务绑定到固定线程，线程也可能被调度到别的核上，所以“谁初始化谁读取”只是大致成立；
+要严格对应，需要把线程绑核（见 15_Concurrency_Parallelism 的 cpuAffinity.h）并让初始化与计算使用同一个线程-块映射。
+*/
+
+// 默认初始化分配器：construct() 不带参数时执行默认初始化而非值初始化，
+// 因此 std::vector<int, DefaultInitAllocator<int>> v(n) 不会写任何内存
+template<typename T, typename Base = std::allocator<T>>
+class DefaultInitAllocator : public Base {
+public:
+    template<typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U, typename std::allocator_traits<Base>::template rebind_alloc<U>>;
+    };
+
+    using Base::Base;
+    DefaultInitAllocator() = default;
+    template<typename U, typename B>
+    DefaultInitAllocator(const DefaultInitAllocator<U, B>& other) : Base(other) {}
+
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        std::allocator_traits<Base>::construct(static_cast<Base&>(*this), p, std::forward<Args>(args)...);
+    }
+};
+
+template<typename T>
+using FirstTouchVector = std::vector<T, DefaultInitAllocator<T>>;
+
+// 把 data[0, n) 切成 blocks 块（0 表示每个工作线程一块），块边界按 data + i 的地址向上对齐到页，
+// 对每块调用 body(start, end) 并等待全部完成；data 本身不必页对齐（std::vector 的数据通常不是），
+// 首尾两块各自包含一段不满一页的内容
+template<typename T, typename Body>
+void parallelForPages(ThreadPool& pool, const T* data, std::size_t n, std::size_t blocks, Body body) {
+    static const std::uintptr_t page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    if (blocks == 0) blocks = std::max<std::size_t>(1, pool.size());
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(data);
+    const std::size_t blockSize = (n + blocks - 1) / blocks;
+    // 第 k 块理想的起点是 k * blockSize，取其后第一个页边界上（或跨过它）的元素
+    auto boundary = [&](std::size_t k) {
+        std::size_t ideal = std::min(n, k * blockSize);
+        if (ideal == n) return n;
+        std::uintptr_t aligned = (base + ideal * sizeof(T) + page - 1) / page * page;
+        return std::min(n, static_cast<std::size_t>((aligned - base + sizeof(T) - 1) / sizeof(T)));
+    };
+    std::vector<std::future<void>> futures;
+    std::size_t start = 0;
+    for (std::size_t k = 1; start < n; ++k) {
+        std::size_t end = boundary(k);
+        if (end <= start) continue; // 块比一页还小时几块会落在同一页内，合并到下一块
+        futures.push_back(pool.enqueue([&body, start, end]() { body(start, end); }));
+        start = end;
+    }
+    for (auto& fut : futures) fut.get();
+}
+
+// data[i] = gen(i)，由线程池并行写入；blocks 为 0 时每个工作线程一块
+template<typename T, typename Gen>
+void parallelGenerate(ThreadPool& pool, T* data, std::size_t n, Gen gen, std::size_t blocks = 0) {
+    parallelForPages(pool, data, n, blocks, [data, &gen](std::size_t start, std::size_t end) {
+        for (std::size_t i = start; i < end; ++i) data[i] = gen(i);
+    });
+}
+
+template<typename T>
+void parallelFill(ThreadPool& pool, T* data, std::size_t n, const T& value, std::size_t blocks = 0) {
+    parallelForPages(pool, data, n, blocks, [data, &value](std::size_t start, std::size_t end) {
+        std::fill(data + start, data + end, value);
+    });
+}
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef __PARALLELSCAN__H__
+#define __PARALLELSCAN__H__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <type_traits>
+#include <vector>
+#include <immintrin.h>
+#include "threadPool.h"
+
+/*
+并行前缀和（scan）：inclusiveScan / exclusiveScan
+    前缀和的每个输出都依赖前面所有输入，不能像 partialSum 那样各块独立算完再相加。经典的两遍算法：
+        第一遍（reduce）：各块并行求出块内的归约值 s0, s1, ...；
+        串行：由块归约值算出每块的起始进位 c0 = 进位, c1 = c0 op s0, c2 = c1 op s1, ...；
+        第二遍（scan）：各块并行，以自己的进位为起点做块内前缀和。
+    输入被读了两遍。数组远大于缓存时，第二遍又要从内存重新读一次，所以这里按缓存分块：
+        把数组切成若干“轮”，每轮 = 线程数 × TILE（每个 TILE 约 256KB，能放进 L2），一轮之内做完两遍，
+        第二遍读取时数据还在各核的缓存里，内存流量接近“读一遍、写一遍”的下限；轮与轮之间串行传递进位。
+    SIMD：op 为 std::plus<int> / std::plus<float> 且 CPU 支持 AVX2 时，块内前缀和用寄存器内的对数步移位相加
+（8 个元素 3 步：先在每个 128 位通道内错位 1、2 个元素相加，再把低通道的最后一个元素加到高通道），
+其余 op（max、乘法、自定义结构体等）走标量路径。
+    op 只要求满足结合律，不要求交换律（各块的结果总是按从左到右的顺序合并）。
+    in 与 out 可以相同（原地计算）。浮点加法的结合顺序与串行不同，结果会有舍入级别的差异。
+*/
+
+namespace parallel_scan_detail {
+
+// 块内标量前缀和；hasCarry 为 false 表示左侧没有任何元素（只有 inclusive 且处于数组开头时），返回新的进位
+template<typename T, typename Op>
+T scanBlockScalar(const T* in, T* out, std::size_t len, bool hasCarry, T carry, bool exclusive, Op& op) {
+    std::size_t i = 0;
+    if (!hasCarry && len > 0) { // 只有 inclusive 会出现：第一个元素原样输出
+        carry = in[0];
+        out[0] = carry;
+        i = 1;
+    }
+    if (exclusive) {
+        for (; i < len; ++i) {
+            T x = in[i];
+            out[i] = carry;
+            carry = op(carry, x);
+        }
+    } else {
+        for (; i < len; ++i) {
+            carry = op(carry, in[i]);
+            out[i] = carry;
+        }
+    }
+    return carry;
+}
+
+template<typename T, typename Op>
+T reduceBlockScalar(const T* in, std::size_t len, Op& op) {
+    T acc = in[0];
+    for (std::size_t i = 1; i < len; ++i) acc = op(acc, in[i]);
+    return acc;
+}
+
+inline bool hasAvx2() {
+    static const bool supported = []() { __builtin_cpu_init(); return __builtin_cpu_supports("avx2") != 0; }();
+    return supported;
+}
+
+// 寄存器内 8 个 int 的 inclusive 前缀和
+__attribute__((target("avx2"))) inline __m256i prefix8(__m256i x) {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    __m256i low3 = _mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));    // 各通道广播自己的第 3 个元素
+    return _mm256_add_epi32(x, _mm256_permute2x128_si256(low3, low3, 0x08)); // 低通道清零，高通道加上低通道之和
+}
+
+__attribute__((target("avx2"))) inline __m256 prefix8(__m256 x) {
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    __m256 low3 = _mm256_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_add_ps(x, _mm256_permute2f128_ps(low3, low3, 0x08));
+}
+
+struct Avx2Int {
+    using V = __m256i;
+    __attribute__((target("avx2"))) static V load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    __attribute__((target("avx2"))) static void store(int* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    __attribute__((target("avx2"))) static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    __attribute__((target("avx2"))) static V set1(int v) { return _mm256_set1_epi32(v); }
+    __attribute__((target("avx2"))) static V permute(V v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+    __attribute__((target("avx2"))) static V blendFirst(V v, V first) { return _mm256_blend_epi32(v, first, 0x01); }
+};
+
+struct Avx2Float {
+    using V = __m256;
+    __attribute__((target("avx2"))) static V load(const float* p) { return _mm256_loadu_ps(p); }
+    __attribute__((target("avx2"))) static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    __attribute__((target("avx2"))) static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    __attribute__((target("avx2"))) static V set1(float v) { return _mm256_set1_ps(v); }
+    __attribute__((target("avx2"))) static V permute(V v, __m256i idx) { return _mm256_permutevar8x32_ps(v, idx); }
+    __attribute__((target("avx2"))) static V blendFirst(V v, V first) { return _mm256_blend_ps(v, first, 0x01); }
+};
+
+// AVX2 块内前缀和（加法）：每 8 个元素做一次寄存器内前缀和，再加上广播的进位
+template<typename T, typename Ops>
+__attribute__((target("avx2"))) T scanBlockAvx2(const T* in, T* out, std::size_t len, T carry, bool exclusive) {
+    const __m256i last = _mm256_set1_epi32(7);
+    const __m256i shiftRight = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+    typename Ops::V vcarry = Ops::set1(carry);
+    std::size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        typename Ops::V p = prefix8(Ops::load(in + i));
+        typename Ops::V inclusive = Ops::add(p, vcarry);
+        // exclusive：整体右移一个元素，第一个元素就是进位本身
+        Ops::store(out + i, exclusive ? Ops::blendFirst(Ops::permute(inclusive, shiftRight), vcarry) : inclusive);
+        vcarry = Ops::permute(inclusive, last);
+    }
+    alignas(32) T tail[8];
+    Ops::store(tail, vcarry);
+    std::plus<T> op;
+    return scanBlockScalar(in + i, out + i, len - i, true, tail[0], exclusive, op);
+}
+
+template<typename T>
+__attribute__((target("avx2"))) T reduceBlockAvx2(const T* in, std::size_t len) {
+    using Ops = typename std::conditional<std::is_same<T, int>::value, Avx2Int, Avx2Float>::type;
+    typename Ops::V acc0 = Ops::set1(T(0)), acc1 = acc0;
+    std::size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        acc0 = Ops::add(acc0, Ops::load(in + i));
+        acc1 = Ops::add(acc1, Ops::load(in + i + 8));
+    }
+    alignas(32) T lanes[8];
+    Ops::store(lanes, Ops::add(acc0, acc1));
+    T acc = T(0);
+    for (T x : lanes) acc += x;
+    for (; i < len; ++i) acc += in[i];
+    return acc;
+}
+
+// op 是 std::plus<int> / std::plus<float>（或透明的 std::plus<>）时可以走 SIMD
+template<typename T, typename Op>
+struct SimdScannable
+    : std::integral_constant<bool, (std::is_same<T, int>::value || std::is_same<T, float>::value) &&
+                                   (std::is_same<Op, std::plus<T>>::value || std::is_same<Op, std::plus<>>::value)> {};
+
+template<typename T, typename Op>
+T scanBlock(const T* in, T* out, std::size_t len, bool hasCarry, T carry, bool exclusive, Op& op) {
+    if constexpr (SimdScannable<T, Op>::value) {
+        if (hasAvx2()) {
+            using Ops = typename std::conditional<std::is_same<T, int>::value, Avx2Int, Avx2Float>::type;
+            return scanBlockAvx2<T, Ops>(in, out, len, hasCarry ? carry : T(0), exclusive);
+        }
+    }
+    return scanBlockScalar(in, out, len, hasCarry, carry, exclusive, op);
+}
+
+template<typename T, typename Op>
+T reduceBlock(const T* in, std::size_t len, Op& op) {
+    if constexpr (SimdScannable<T, Op>::value) {
+        if (hasAvx2()) return reduceBlockAvx2<T>(in, len);
+    }
+    return reduceBlockScalar(in, len, op);
+}
+
+// 每块约 256KB：输入加输出能放进大多数 CPU 的 L2
+template<typename T>
+constexpr std::size_t tileElems() { return std::max<std::size_t>(1024, (std::size_t(256) << 10) / sizeof(T)); }
+
+template<typename T, typename Op>
+void scanImpl(ThreadPool& pool, const T* in, T* out, std::size_t n, bool hasCarry, T carry, bool exclusive, Op op) {
+    const std::size_t tile = tileElems<T>();
+    const std::size_t threads = std::max<std::size_t>(1, pool.size());
+    if (threads == 1 || n < 2 * tile) {
+        scanBlock(in, out, n, hasCarry, carry, exclusive, op);
+        return;
+    }
+    std::vector<T> sums(threads);
+    std::vector<T> carries(threads);
+    std::vector<std::future<T>> futures;
+    for (std::size_t round = 0; round < n; round += threads * tile) {
+        const std::size_t tiles = std::min(threads, (n - round + tile - 1) / tile);
+        auto tileLen = [&](std::size_t t) { return std::min(tile, n - round - t * tile); };
+        // 第一遍：除最后一块外各块的归约值（最后一块的归约值不影响本轮任何输出）
+        futures.clear();
+        for (std::size_t t = 0; t + 1 < tiles; ++t) {
+            const T* p = in + round + t * tile;
+            std::size_t len = tileLen(t);
+            futures.push_back(pool.enqueue([p, len, &op]() { return reduceBlock(p, len, op); }));
+        }
+        for (std::size_t t = 0; t + 1 < tiles; ++t) sums[t] = futures[t].get();
+        // 串行：各块的起始进位。只有整个数组的第一块可能没有进位
+        bool firstHasCarry = hasCarry;
+        for (std::size_t t = 0; t < tiles; ++t) {
+            if (t == 0) carries[0] = carry;
+            else carries[t] = (t == 1 && !firstHasCarry) ? sums[0] : op(carries[t - 1], sums[t - 1]);
+        }
+        // 第二遍：各块以自己的进位为起点做块内前缀和，数据此时还在缓存中
+        futures.clear();
+        for (std::size_t t = 0; t < tiles; ++t) {
+            const T* src = in + round + t * tile;
+            T* dst = out + round + t * tile;
+            std::size_t len = tileLen(t);
+            bool has = t > 0 || firstHasCarry;
+            T c = carries[t];
+            futures.push_back(pool.enqueue([src, dst, len, has, c, exclusive, &op]() {
+                return scanBlock(src, dst, len, has, c, exclusive, op);
+            }));
+        }
+        for (std::size_t t = 0; t < tiles; ++t) {
+            T next = futures[t].get();
+            if (t + 1 == tiles) carry = next;
+        }
+        hasCarry = true;
+    }
+}
+
+} // namespace parallel_scan_detail
+
+// out[i] = in[0] op in[1] op ... op in[i]
+template<typename T, typename Op = std::plus<T>>
+void inclusiveScan(ThreadPool& pool, const T* in, T* out, std::size_t n, Op op = Op()) {
+    parallel_scan_detail::scanImpl(pool, in, out, n, false, T(), false, op);
+}
+
+// out[i] = init op in[0] op ... op in[i-1]，out[0] = init
+template<typename T, typename Op = std::plus<T>>
+void exclusiveScan(ThreadPool& pool, const T* in, T* out, std::size_t n, T init, Op op = Op()) {
+    parallel_scan_detail::scanImpl(pool, in, out, n, true, init, true, op);
+}
+
+// 正确性检查：int/float 加法、max 与不满足交换律的仿射复合，inclusive/exclusive、原地，与串行结果逐元素比较
+bool checkParallelScan();
+// 基准测试：std::partial_sum、std::inclusive_scan(std::execution::par)（需要 TBB）与 inclusiveScan 的耗时对比
+void benchParallelScan(std::size_t n = 100000000);
+
+#endif
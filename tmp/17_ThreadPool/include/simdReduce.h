@@ -0,0 +1,364 @@
+#ifndef __SIMDREDUCE__H__
+#define __SIMDREDUCE__H__
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <immintrin.h>
+#include "threadPool.h"
+
+/*
+SIMD 归约库（只有头文件）：sum、sumSquares、minMax（带下标）、dot、byteHistogram
+    支持的元素类型：int（结果以 long long 累加，溢出时按补码回绕）和 float（结果以 double 累加，float*float 在 double 中是精确的）。
+    1. 指令集分级：Scalar -> SSE4.1 -> AVX2 -> AVX-512，运行时用 __builtin_cpu_supports 检测，默认选 CPU 支持的最高一级，
+       也可以显式指定某一级（用于对比测试）。
+    2. 内核只写一份（simdReduceKernels.inl），针对“向量操作集合 Ops”编程；每个指令集在自己的命名空间里定义 Ops，
+       再在 #pragma GCC target 区域内包含一次 .inl，编译器就为每个指令集各生成一套代码，
+       工程本身不需要 -mavx2 等编译选项，在老 CPU 上也能运行（只是不会分派到高级别的内核）。
+    3. 整数乘法用 mul_epi32：取每个 64 位通道低 32 位做有符号乘法得到 64 位积，偶数通道直接乘，奇数通道右移 32 位后再乘，
+       这样 sum（乘 1）、sumSquares、dot 都是同一个“扩展乘加”循环。
+    4. minMax：每个通道各自记录最值和 32 位下标，循环结束后再在通道间归并，相等时取最小下标，结果与顺序扫描一致；
+       输入不能包含 NaN（与 std::min_element 一样，NaN 的比较结果没有意义）。
+    5. byteHistogram 的瓶颈是对同一个计数器反复“读-改-写”的依赖链，而不是算力，SIMD 帮不上忙：
+       Scalar 级别用一张计数表，其余级别用 4 张子表交错计数打散依赖，最后合并。
+    6. 传入 ThreadPool 且元素数超过 SIMD_REDUCE_PARALLEL_MIN 时，按块分给线程池，块内再用 SIMD 内核。
+*/
+
+enum class SimdLevel { Scalar, Sse41, Avx2, Avx512 };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::Sse41: return "SSE4.1";
+        case SimdLevel::Avx2: return "AVX2";
+        case SimdLevel::Avx512: return "AVX-512";
+    }
+    return "unknown";
+}
+
+inline bool simdLevelSupported(SimdLevel level) {
+    __builtin_cpu_init();
+    switch (level) {
+        case SimdLevel::Scalar: return true;
+        case SimdLevel::Sse41: return __builtin_cpu_supports("sse4.1");
+        case SimdLevel::Avx2: return __builtin_cpu_supports("avx2");
+        case SimdLevel::Avx512: return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+}
+
+// 当前 CPU 支持的最高级别（只检测一次）
+inline SimdLevel bestSimdLevel() {
+    static const SimdLevel best = []() {
+        for (SimdLevel level : {SimdLevel::Avx512, SimdLevel::Avx2, SimdLevel::Sse41})
+            if (simdLevelSupported(level)) return level;
+        return SimdLevel::Scalar;
+    }();
+    return best;
+}
+
+template<typename T> struct ReduceTraits;               // 只支持 int 与 float
+template<> struct ReduceTraits<int> { using Acc = long long; };
+template<> struct ReduceTraits<float> { using Acc = double; };
+
+// 整数结果用无符号加法累加：溢出时按补码回绕（与 SIMD 的 add_epi64 一致），不会触发有符号溢出的未定义行为
+inline long long accAdd(long long a, long long b) {
+    return static_cast<long long>(static_cast<unsigned long long>(a) + static_cast<unsigned long long>(b));
+}
+inline double accAdd(double a, double b) { return a + b; }
+
+template<typename T>
+struct MinMaxResult {
+    T minValue;
+    std::size_t minIndex;   // 第一次出现的位置
+    T maxValue;
+    std::size_t maxIndex;
+};
+
+namespace simd_reduce_scalar {
+struct Ops {
+    static constexpr std::size_t W = 1;
+    using VI = int; using VF = float; using AccI = long long; using AccF = double; using Mask = bool;
+    static VI load(const int* p) { return *p; }
+    static VF load(const float* p) { return *p; }
+    static VI set1(int v) { return v; }
+    static VF set1(float v) { return v; }
+    static void store(int* p, VI v) { *p = v; }
+    static void store(float* p, VF v) { *p = v; }
+    static void mulAdd(AccI& acc, VI a, VI b) { acc = accAdd(acc, static_cast<long long>(a) * b); }
+    static void mulAdd(AccF& acc, VF a, VF b) { acc += static_cast<double>(a) * b; }
+    static long long hsum(AccI acc) { return acc; }
+    static double hsum(AccF acc) { return acc; }
+    static Mask less(VI a, VI b) { return a < b; }
+    static Mask less(VF a, VF b) { return a < b; }
+    static VI select(Mask m, VI a, VI b) { return m ? a : b; }
+    static VF select(Mask m, VF a, VF b) { return m ? a : b; }
+    static VI iota() { return 0; }
+    static VI add32(VI a, VI b) { return a + b; }
+};
+#include "simdReduceKernels.inl"
+} // namespace simd_reduce_scalar
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+namespace simd_reduce_sse41 {
+struct Ops {
+    static constexpr std::size_t W = 4;
+    using VI = __m128i; using VF = __m128; using AccI = __m128i; using AccF = __m128d; using Mask = __m128i;
+    static VI load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static VF load(const float* p) { return _mm_loadu_ps(p); }
+    static VI set1(int v) { return _mm_set1_epi32(v); }
+    static VF set1(float v) { return _mm_set1_ps(v); }
+    static void store(int* p, VI v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static void store(float* p, VF v) { _mm_storeu_ps(p, v); }
+    static void mulAdd(AccI& acc, VI a, VI b) {
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(a, b));
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)));
+    }
+    static void mulAdd(AccF& acc, VF a, VF b) {
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_cvtps_pd(a), _mm_cvtps_pd(b)));
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), _mm_cvtps_pd(_mm_movehl_ps(b, b))));
+    }
+    static long long hsum(AccI acc) { return accAdd(_mm_cvtsi128_si64(acc), _mm_extract_epi64(acc, 1)); }
+    static double hsum(AccF acc) { return _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc))); }
+    static Mask less(VI a, VI b) { return _mm_cmplt_epi32(a, b); }
+    static Mask less(VF a, VF b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+    static VI select(Mask m, VI a, VI b) { return _mm_blendv_epi8(b, a, m); }
+    static VF select(Mask m, VF a, VF b) { return _mm_blendv_ps(b, a, _mm_castsi128_ps(m)); }
+    static VI iota() { return _mm_setr_epi32(0, 1, 2, 3); }
+    static VI add32(VI a, VI b) { return _mm_add_epi32(a, b); }
+};
+#include "simdReduceKernels.inl"
+} // namespace simd_reduce_sse41
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace simd_reduce_avx2 {
+struct Ops {
+    static constexpr std::size_t W = 8;
+    using VI = __m256i; using VF = __m256; using AccI = __m256i; using AccF = __m256d; using Mask = __m256i;
+    static VI load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static VF load(const float* p) { return _mm256_loadu_ps(p); }
+    static VI set1(int v) { return _mm256_set1_epi32(v); }
+    static VF set1(float v) { return _mm256_set1_ps(v); }
+    static void store(int* p, VI v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static void store(float* p, VF v) { _mm256_storeu_ps(p, v); }
+    static void mulAdd(AccI& acc, VI a, VI b) {
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(a, b));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)));
+    }
+    static void mulAdd(AccF& acc, VF a, VF b) {
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a)),
+                                               _mm256_cvtps_pd(_mm256_castps256_ps128(b))));
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)),
+                                               _mm256_cvtps_pd(_mm256_extractf128_ps(b, 1))));
+    }
+    static long long hsum(AccI acc) {
+        __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        return accAdd(_mm_cvtsi128_si64(s), _mm_extract_epi64(s, 1));
+    }
+    static double hsum(AccF acc) {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+    static Mask less(VI a, VI b) { return _mm256_cmpgt_epi32(b, a); }
+    static Mask less(VF a, VF b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static VI select(Mask m, VI a, VI b) { return _mm256_blendv_epi8(b, a, m); }
+    static VF select(Mask m, VF a, VF b) { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(m)); }
+    static VI iota() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static VI add32(VI a, VI b) { return _mm256_add_epi32(a, b); }
+};
+#include "simdReduceKernels.inl"
+} // namespace simd_reduce_avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+namespace simd_reduce_avx512 {
+struct Ops {
+    static constexpr std::size_t W = 16;
+    using VI = __m512i; using VF = __m512; using AccI = __m512i; using AccF = __m512d; using Mask = __mmask16;
+    static VI load(const int* p) { return _mm512_loadu_si512(p); }
+    static VF load(const float* p) { return _mm512_loadu_ps(p); }
+    static VI set1(int v) { return _mm512_set1_epi32(v); }
+    static VF set1(float v) { return _mm512_set1_ps(v); }
+    static void store(int* p, VI v) { _mm512_storeu_si512(p, v); }
+    static void store(float* p, VF v) { _mm512_storeu_ps(p, v); }
+    static void mulAdd(AccI& acc, VI a, VI b) {
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(a, b));
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32)));
+    }
+    static __m256 high(VF v) { return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)); }
+    static void mulAdd(AccF& acc, VF a, VF b) {
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(a)),
+                                               _mm512_cvtps_pd(_mm512_castps512_ps256(b))));
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_cvtps_pd(high(a)), _mm512_cvtps_pd(high(b))));
+    }
+    static long long hsum(AccI acc) { // _mm512_reduce_add_epi64 内部是有符号加法，这里逐级用 add_epi64 归约
+        __m256i s4 = _mm256_add_epi64(_mm512_castsi512_si256(acc), _mm512_extracti64x4_epi64(acc, 1));
+        __m128i s = _mm_add_epi64(_mm256_castsi256_si128(s4), _mm256_extracti128_si256(s4, 1));
+        return accAdd(_mm_cvtsi128_si64(s), _mm_extract_epi64(s, 1));
+    }
+    static double hsum(AccF acc) { return _mm512_reduce_add_pd(acc); }
+    static Mask less(VI a, VI b) { return _mm512_cmplt_epi32_mask(a, b); }
+    static Mask less(VF a, VF b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static VI select(Mask m, VI a, VI b) { return _mm512_mask_blend_epi32(m, b, a); }
+    static VF select(Mask m, VF a, VF b) { return _mm512_mask_blend_ps(m, b, a); }
+    static VI iota() { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+    static VI add32(VI a, VI b) { return _mm512_add_epi32(a, b); }
+};
+#include "simdReduceKernels.inl"
+} // namespace simd_reduce_avx512
+#pragma GCC pop_options
+
+// 按指令集级别分派的内核表
+template<typename T>
+struct ReduceKernels {
+    using Acc = typename ReduceTraits<T>::Acc;
+    Acc (*sum)(const T*, std::size_t);
+    Acc (*sumSquares)(const T*, std::size_t);
+    Acc (*dot)(const T*, const T*, std::size_t);
+    MinMaxResult<T> (*minMax)(const T*, std::size_t);
+};
+
+template<typename T>
+const ReduceKernels<T>& reduceKernels(SimdLevel level) {
+    static const ReduceKernels<T> table[] = {
+        {simd_reduce_scalar::sum<T>, simd_reduce_scalar::sumSquares<T>, simd_reduce_scalar::dot<T>, simd_reduce_scalar::minMax<T>},
+        {simd_reduce_sse41::sum<T>, simd_reduce_sse41::sumSquares<T>, simd_reduce_sse41::dot<T>, simd_reduce_sse41::minMax<T>},
+        {simd_reduce_avx2::sum<T>, simd_reduce_avx2::sumSquares<T>, simd_reduce_avx2::dot<T>, simd_reduce_avx2::minMax<T>},
+        {simd_reduce_avx512::sum<T>, simd_reduce_avx512::sumSquares<T>, simd_reduce_avx512::dot<T>, simd_reduce_avx512::minMax<T>},
+    };
+    if (!simdLevelSupported(level))
+        throw std::invalid_argument(std::string("SIMD level not supported by this CPU: ") + simdLevelName(level));
+    return table[static_cast<int>(level)];
+}
+
+// 超过这个元素数且传入了线程池时才并行，太小的输入分块调度的开销比计算本身还大
+constexpr std::size_t SIMD_REDUCE_PARALLEL_MIN = 1 << 18;
+
+// 把 [0, n) 切成 64 元素对齐的块，block(start, len) 在线程池中计算各块，combine 按块的顺序合并
+template<typename R, typename Block, typename Combine>
+R parallelReduce(ThreadPool* pool, std::size_t n, Block block, Combine combine) {
+    if (!pool || pool->size() <= 1 || n < SIMD_REDUCE_PARALLEL_MIN)
+        return block(std::size_t(0), n);
+    std::size_t blocks = pool->size() * 4;
+    std::size_t blockSize = ((n + blocks - 1) / blocks + 63) & ~static_cast<std::size_t>(63);
+    std::vector<std::future<R>> futures;
+    for (std::size_t start = 0; start < n; start += blockSize) {
+        std::size_t len = std::min(blockSize, n - start);
+        futures.push_back(pool->enqueue([&block, start, len]() { return block(start, len); }));
+    }
+    R result = futures[0].get();
+    for (std::size_t i = 1; i < futures.size(); ++i)
+        result = combine(result, futures[i].get());
+    return result;
+}
+
+template<typename T>
+typename ReduceTraits<T>::Acc reduceSum(const T* data, std::size_t n, ThreadPool* pool = nullptr,
+                                        SimdLevel level = bestSimdLevel()) {
+    using Acc = typename ReduceTraits<T>::Acc;
+    auto kernel = reduceKernels<T>(level).sum;
+    return parallelReduce<Acc>(pool, n, [&](std::size_t s, std::size_t len) { return kernel(data + s, len); },
+                               [](Acc a, Acc b) { return accAdd(a, b); });
+}
+
+template<typename T>
+typename ReduceTraits<T>::Acc reduceSumSquares(const T* data, std::size_t n, ThreadPool* pool = nullptr,
+                                               SimdLevel level = bestSimdLevel()) {
+    using Acc = typename ReduceTraits<T>::Acc;
+    auto kernel = reduceKernels<T>(level).sumSquares;
+    return parallelReduce<Acc>(pool, n, [&](std::size_t s, std::size_t len) { return kernel(data + s, len); },
+                               [](Acc a, Acc b) { return accAdd(a, b); });
+}
+
+template<typename T>
+typename ReduceTraits<T>::Acc reduceDot(const T* a, const T* b, std::size_t n, ThreadPool* pool = nullptr,
+                                        SimdLevel level = bestSimdLevel()) {
+    using Acc = typename ReduceTraits<T>::Acc;
+    auto kernel = reduceKernels<T>(level).dot;
+    return parallelReduce<Acc>(pool, n, [&](std::size_t s, std::size_t len) { return kernel(a + s, b + s, len); },
+                               [](Acc x, Acc y) { return accAdd(x, y); });
+}
+
+// n 为 0 时抛出 std::invalid_argument
+template<typename T>
+MinMaxResult<T> reduceMinMax(const T* data, std::size_t n, ThreadPool* pool = nullptr,
+                             SimdLevel level = bestSimdLevel()) {
+    if (n == 0) throw std::invalid_argument("reduceMinMax on empty range");
+    auto kernel = reduceKernels<T>(level).minMax;
+    // 前一段的结果在前，相等时保留前一段的下标
+    auto combine = [](const MinMaxResult<T>& x, const MinMaxResult<T>& y) {
+        MinMaxResult<T> r = x;
+        if (y.minValue < r.minValue) r.minValue = y.minValue, r.minIndex = y.minIndex;
+        if (y.maxValue > r.maxValue) r.maxValue = y.maxValue, r.maxIndex = y.maxIndex;
+        return r;
+    };
+    auto block = [&](std::size_t start, std::size_t len) {
+        const std::size_t CHUNK = std::size_t(1) << 30; // 内核的通道下标是 32 位的
+        MinMaxResult<T> r{};
+        for (std::size_t off = 0; off < len; off += CHUNK) {
+            MinMaxResult<T> part = kernel(data + start + off, std::min(CHUNK, len - off));
+            part.minIndex += start + off;
+            part.maxIndex += start + off;
+            r = off == 0 ? part : combine(r, part);
+        }
+        return r;
+    };
+    return parallelReduce<MinMaxResult<T>>(pool, n, block, combine);
+}
+
+using ByteHistogram = std::array<std::uint64_t, 256>;
+
+inline ByteHistogram byteHistogram(const std::uint8_t* data, std::size_t n, ThreadPool* pool = nullptr,
+                                   SimdLevel level = bestSimdLevel()) {
+    auto block = [&](std::size_t start, std::size_t len) {
+        ByteHistogram hist{};
+        const std::uint8_t* p = data + start;
+        if (level == SimdLevel::Scalar) {
+            for (std::size_t i = 0; i < len; ++i) ++hist[p[i]];
+            return hist;
+        }
+        // 4 张 32 位子表，每次读 8 字节，相邻字节落在不同的表里；按 2^31 字节分段，子表计数不会溢出
+        const std::size_t CHUNK = std::size_t(1) << 31;
+        for (std::size_t off = 0; off < len; off += CHUNK) {
+            std::uint32_t sub[4][256] = {};
+            std::size_t end = std::min(len, off + CHUNK), i = off;
+            for (; i + 8 <= end; i += 8) {
+                std::uint64_t w;
+                std::memcpy(&w, p + i, 8);
+                ++sub[0][w & 0xff];
+                ++sub[1][(w >> 8) & 0xff];
+                ++sub[2][(w >> 16) & 0xff];
+                ++sub[3][(w >> 24) & 0xff];
+                ++sub[0][(w >> 32) & 0xff];
+                ++sub[1][(w >> 40) & 0xff];
+                ++sub[2][(w >> 48) & 0xff];
+                ++sub[3][w >> 56];
+            }
+            for (; i < end; ++i) ++sub[0][p[i]];
+            for (int b = 0; b < 256; ++b) hist[b] += std::uint64_t(sub[0][b]) + sub[1][b] + sub[2][b] + sub[3][b];
+        }
+        return hist;
+    };
+    return parallelReduce<ByteHistogram>(pool, n, block, [](ByteHistogram a, const ByteHistogram& b) {
+        for (int i = 0; i < 256; ++i) a[i] += b[i];
+        return a;
+    });
+}
+
+// 正确性检查：各指令集级别（串行 / 线程池）的结果与标量结果逐一比对，打印不一致的用例，全部通过返回 true
+bool checkSimdReduce();
+
+// 基准测试：每个指令集级别下各归约操作的吞吐（GB/s），串行与线程池并行各一组
+void benchSimdReduce(std::size_t n = 1 << 24);
+
+#endif
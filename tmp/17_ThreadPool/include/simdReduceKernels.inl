@@ -0,0 +1,92 @@
+// 通用归约内核，由 simdReduce.h 在每个指令集的命名空间中各包含一次（故意没有头文件保护）。
+// 包含前当前命名空间里必须已经定义好 Ops：
+//     W                         每个向量的 32 位通道数
+//     VI / VF                   int / float 向量；AccI / AccF 为对应的 64 位累加向量（long long / double）
+//     load(p)、set1(v)、store(p, v)
+//     mulAdd(acc, a, b)         acc += 把 a、b 的每个通道扩展成 64 位后相乘
+//     hsum(acc)                 累加向量的横向求和
+//     less(a, b) -> Mask        逐通道 a < b；select(m, a, b) 逐通道 m ? a : b
+//     iota()、add32(a, b)       通道下标 0..W-1 与 32 位整数加法（用于 min/max 的下标向量）
+
+template<typename T> struct Lanes;
+template<> struct Lanes<int> { using V = Ops::VI; using Acc = Ops::AccI; };
+template<> struct Lanes<float> { using V = Ops::VF; using Acc = Ops::AccF; };
+
+enum AccumulateMode { ACC_SUM, ACC_SQUARES, ACC_DOT };
+
+// sum / sumSquares / dot 共用同一个循环：分别是 x*1、x*x、a*b 的累加
+template<int MODE, typename T>
+typename ReduceTraits<T>::Acc multiplyAccumulate(const T* a, const T* b, std::size_t n) {
+    using Result = typename ReduceTraits<T>::Acc;
+    typename Lanes<T>::Acc acc0{}, acc1{};  // 两组累加器，隐藏加法延迟
+    const typename Lanes<T>::V one = Ops::set1(T(1));
+    std::size_t i = 0;
+    for (; i + 2 * Ops::W <= n; i += 2 * Ops::W) {
+        typename Lanes<T>::V x0 = Ops::load(a + i), x1 = Ops::load(a + i + Ops::W);
+        if (MODE == ACC_SUM) {
+            Ops::mulAdd(acc0, x0, one);
+            Ops::mulAdd(acc1, x1, one);
+        } else if (MODE == ACC_SQUARES) {
+            Ops::mulAdd(acc0, x0, x0);
+            Ops::mulAdd(acc1, x1, x1);
+        } else {
+            Ops::mulAdd(acc0, x0, Ops::load(b + i));
+            Ops::mulAdd(acc1, x1, Ops::load(b + i + Ops::W));
+        }
+    }
+    Result r = accAdd(Ops::hsum(acc0), Ops::hsum(acc1));
+    for (; i < n; ++i) {
+        Result x = a[i];
+        r = accAdd(r, MODE == ACC_SUM ? x : MODE == ACC_SQUARES ? x * x : x * static_cast<Result>(b[i]));
+    }
+    return r;
+}
+
+template<typename T>
+typename ReduceTraits<T>::Acc sum(const T* data, std::size_t n) { return multiplyAccumulate<ACC_SUM>(data, data, n); }
+
+template<typename T>
+typename ReduceTraits<T>::Acc sumSquares(const T* data, std::size_t n) { return multiplyAccumulate<ACC_SQUARES>(data, data, n); }
+
+template<typename T>
+typename ReduceTraits<T>::Acc dot(const T* a, const T* b, std::size_t n) { return multiplyAccumulate<ACC_DOT>(a, b, n); }
+
+// 每个通道各自维护最小/最大值及其下标，最后在通道之间归并；相等时取下标较小者，与顺序扫描的结果一致。
+// 通道下标是 32 位的，调用方保证 n < 2^31（simdReduce.h 中按 2^30 分段调用）
+template<typename T>
+MinMaxResult<T> minMax(const T* data, std::size_t n) {
+    MinMaxResult<T> r{data[0], 0, data[0], 0};
+    std::size_t i = 1;
+    if (n >= Ops::W) {
+        typename Lanes<T>::V vmin = Ops::load(data), vmax = vmin;
+        Ops::VI idx = Ops::iota(), minIdx = idx, maxIdx = idx;
+        const Ops::VI step = Ops::set1(static_cast<int>(Ops::W));
+        for (i = Ops::W; i + Ops::W <= n; i += Ops::W) {
+            typename Lanes<T>::V x = Ops::load(data + i);
+            idx = Ops::add32(idx, step);
+            Ops::Mask lt = Ops::less(x, vmin), gt = Ops::less(vmax, x);
+            vmin = Ops::select(lt, x, vmin);
+            minIdx = Ops::select(lt, idx, minIdx);
+            vmax = Ops::select(gt, x, vmax);
+            maxIdx = Ops::select(gt, idx, maxIdx);
+        }
+        alignas(64) T mins[Ops::W], maxs[Ops::W];
+        alignas(64) int minAt[Ops::W], maxAt[Ops::W];
+        Ops::store(mins, vmin);
+        Ops::store(maxs, vmax);
+        Ops::store(minAt, minIdx);
+        Ops::store(maxAt, maxIdx);
+        r = {mins[0], static_cast<std::size_t>(minAt[0]), maxs[0], static_cast<std::size_t>(maxAt[0])};
+        for (std::size_t k = 1; k < Ops::W; ++k) {
+            if (mins[k] < r.minValue || (mins[k] == r.minValue && static_cast<std::size_t>(minAt[k]) < r.minIndex))
+                r.minValue = mins[k], r.minIndex = minAt[k];
+            if (maxs[k] > r.maxValue || (maxs[k] == r.maxValue && static_cast<std::size_t>(maxAt[k]) < r.maxIndex))
+                r.maxValue = maxs[k], r.maxIndex = maxAt[k];
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] < r.minValue) r.minValue = data[i], r.minIndex = i;
+        if (data[i] > r.maxValue) r.maxValue = data[i], r.maxIndex = i;
+    }
+    return r;
+}
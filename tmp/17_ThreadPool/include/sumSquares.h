@@ -0,0 +1,52 @@
+#ifndef __SUMSQUARES__H__
+#define __SUMSQUARES__H__
+
+#include <cstddef>
+#include <vector>
+#include "threadPool.h"
+
+/*
+SIMD 平方和：partialSum 的向量化版本
+    partialSum 每次把一个 int 扩展成 long long 再相乘，编译器一般只能生成标量代码（或很窄的向量代码）。
+    这里手写几个内核，都以 64 位累加（无符号加法，溢出时按补码回绕），结果彼此一致，不溢出时与 partialSum 完全相同：
+        1. AVX-512：_mm512_mul_epi32 一次把 8 对“偶数位置的 32 位有符号整数”相乘得到 8 个 64 位积，
+           奇数位置的元素右移 32 位后再乘一次，每次处理 16 个 int；
+        2. AVX2：同样的思路，每次处理 8 个 int；
+        3. SSE2：SSE2 只有无符号的 _mm_mul_epu32，先取绝对值（x*x == |x|*|x|），每次处理 4 个 int；
+        4. 标量：与 partialSum 相同的循环。
+    运行时分派：第一次调用 sumSquaresKernel() 时用 __builtin_cpu_supports 检测 CPU 支持的指令集，选择最快的内核。
+    各内核用 __attribute__((target(...))) 单独编译，不需要给整个工程加 -mavx2/-mavx512f，
+程序在不支持这些指令的机器上照样能运行。
+    parallelSumSquares：把数组切成若干块，交给 ThreadPool 并行计算，每块内部再用 SIMD 内核，SIMD 与多核的加速叠加。
+注意：平方和是典型的访存密集型计算（每读 4 字节只做一次乘加），数据不在缓存中时，
+多线程 + SIMD 的上限是内存带宽，benchSumSquares 会同时给出只读不算的并行读带宽（roofline）作对照：
+用最宽的 SIMD 内核读一块数倍于末级缓存的缓冲区测得。
+*/
+
+using SumSquaresKernel = long long (*)(const int* data, std::size_t n);
+
+long long sumSquaresScalar(const int* data, std::size_t n);
+long long sumSquaresSse2(const int* data, std::size_t n);
+long long sumSquaresAvx2(const int* data, std::size_t n);
+long long sumSquaresAvx512(const int* data, std::size_t n);
+
+struct SumSquaresIsa {
+    const char* name;
+    SumSquaresKernel kernel;
+    bool supported;
+};
+
+// 所有内核及当前 CPU 是否支持，按 标量 -> SSE2 -> AVX2 -> AVX-512 排列
+std::vector<SumSquaresIsa> sumSquaresIsaList();
+
+// 当前 CPU 上最快的内核（只检测一次）
+SumSquaresKernel sumSquaresKernel();
+
+// 把 [data, data + n) 切成 blocks 块（0 表示线程数的 4 倍）交给线程池，各块用 kernel 计算后汇总
+long long parallelSumSquares(ThreadPool& pool, const int* data, std::size_t n,
+                             SumSquaresKernel kernel = sumSquaresKernel(), std::size_t blocks = 0);
+
+// 基准测试：各指令集 串行/并行 的耗时与 GB/s，并与测得的内存读带宽对比
+void benchSumSquares(std::size_t dataSize = 10000000);
+
+#endif
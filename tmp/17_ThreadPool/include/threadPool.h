@@ -51,6 +51,9 @@ public:
     // 关闭线程池，等待所有线程结束
     void shutdown();
 
+    // 工作线程数
+    size_t size() const { return workers.size(); }
+
 private:
     // 工作线程函数，不断从任务队列中取任务执行
     void worker();
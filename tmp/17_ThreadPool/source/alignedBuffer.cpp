@@ -0,0 +1,150 @@
+#include "alignedBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include "parallelFill.h"
+#include "simdReduce.h"
+
+namespace {
+
+bool useMmap(std::size_t bytes) { return bytes >= HUGE_PAGE_SIZE / 2; }
+
+std::size_t roundToHugePage(std::size_t bytes) { return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1); }
+
+// 多映射一个大页再裁掉首尾，得到按 2 MB 对齐、长度为 length 的匿名映射
+void* mapHugeAligned(std::size_t length) {
+    std::size_t padded = length + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(raw);
+    std::uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (aligned > begin) munmap(raw, aligned - begin);
+    std::size_t tail = begin + padded - (aligned + length);
+    if (tail > 0) munmap(reinterpret_cast<void*>(aligned + length), tail);
+    return reinterpret_cast<void*>(aligned);
+}
+
+} // namespace
+
+const char* hugePagesName(HugePages mode) {
+    switch (mode) {
+        case HugePages::None: return "4KB 页";
+        case HugePages::Transparent: return "透明大页(MADV_HUGEPAGE)";
+        case HugePages::Explicit: return "hugetlb(MAP_HUGETLB)";
+    }
+    return "unknown";
+}
+
+void* alignedAllocate(std::size_t bytes, HugePages mode, HugePages* applied) {
+    if (applied) *applied = HugePages::None;
+    if (!useMmap(bytes))
+        return ::operator new(std::max<std::size_t>(bytes, 1), std::align_val_t(SIMD_ALIGNMENT));
+
+    std::size_t length = roundToHugePage(bytes);
+    if (mode == HugePages::Explicit) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            if (applied) *applied = HugePages::Explicit;
+            return p;
+        }
+        mode = HugePages::Transparent; // 大页池不足（或未配置）：退回透明大页
+    }
+    void* p = mapHugeAligned(length);
+    if (!p) throw std::bad_alloc();
+    // madvise 失败（例如内核未开启 THP）不影响正确性，只是仍用 4 KB 页
+    if (mode == HugePages::Transparent) {
+        if (madvise(p, length, MADV_HUGEPAGE) == 0 && applied) *applied = HugePages::Transparent;
+    } else {
+        madvise(p, length, MADV_NOHUGEPAGE);
+    }
+    return p;
+}
+
+void alignedDeallocate(void* p, std::size_t bytes, HugePages) noexcept {
+    if (!p) return;
+    if (!useMmap(bytes)) {
+        ::operator delete(p, std::align_val_t(SIMD_ALIGNMENT));
+        return;
+    }
+    munmap(p, roundToHugePage(bytes)); // hugetlb 与普通映射的长度都是 2 MB 的整数倍
+}
+
+std::size_t hugePageBytes(const void* p) {
+    std::ifstream smaps("/proc/self/smaps");
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+    std::string line;
+    bool inside = false;
+    std::size_t kb = 0;
+    while (std::getline(smaps, line)) {
+        unsigned long long start, end;
+        // 映射的首行形如 "7f12a0000000-7f12c0000000 rw-p ..."
+        if (std::sscanf(line.c_str(), "%llx-%llx ", &start, &end) == 2 && line.find(':') > line.find(' ')) {
+            if (inside) break;
+            inside = addr >= start && addr < end;
+            continue;
+        }
+        if (!inside) continue;
+        std::istringstream in(line);
+        std::string key;
+        std::size_t value = 0;
+        in >> key >> value;
+        if (key == "AnonHugePages:" || key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") kb += value;
+    }
+    return kb * 1024;
+}
+
+namespace {
+
+template<typename F>
+double secondsOf(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+void benchHugePages(std::size_t bytes) {
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t n = bytes / sizeof(int);
+    // 随机访问的下标对三种方式相同；访问次数固定，避免数据量大时耗时过长
+    const std::size_t probes = std::min<std::size_t>(n, 1 << 24);
+    std::vector<std::uint32_t> idx(probes);
+    std::mt19937 rng(42);
+    for (auto& i : idx) i = static_cast<std::uint32_t>(rng() % n);
+
+    std::cout << "大页基准测试: " << (bytes >> 20) << " MB int 数组, 线程数 = " << pool.size() << std::endl;
+    long long expected = -1;
+    for (HugePages mode : {HugePages::None, HugePages::Transparent, HugePages::Explicit}) {
+        AlignedBuffer<int> buf;
+        double faultSec = secondsOf([&]() {
+            buf = AlignedBuffer<int>(n, mode);
+            parallelGenerate(pool, buf.data(), n, [](std::size_t i) { return static_cast<int>(i % 100); });
+        });
+        double scanSec = 1e30;
+        long long sum = 0;
+        for (int r = 0; r < 3; ++r)
+            scanSec = std::min(scanSec, secondsOf([&]() { sum = reduceSum(buf.data(), n, &pool); }));
+        long long gathered = 0;
+        double randomSec = secondsOf([&]() {
+            for (std::uint32_t i : idx) gathered += buf[i];
+        });
+        if (expected < 0) expected = sum + gathered;
+        std::cout << "请求 " << hugePagesName(mode) << ", 实际 " << hugePagesName(buf.hugePages())
+                  << ", 大页覆盖 " << (hugePageBytes(buf.data()) >> 20) << " MB"
+                  << "  分配+首次写入: " << faultSec * 1e3 << " ms"
+                  << "  顺序扫描: " << bytes / scanSec / 1e9 << " GB/s"
+                  << "  随机访问: " << randomSec * 1e9 / probes << " ns/次"
+                  << (sum + gathered == expected ? "" : "  (校验失败!)") << std::endl;
+    }
+}
@@ -2,7 +2,13 @@
 #include <vector>
 #include <numeric>   // std::accumulate
 #include "threadPool.h" // 假设上面线程池实现放在这个头文件中
+#include "sumSquares.h" // partialSum 的 SIMD 版本（运行时选择 AVX-512/AVX2/SSE2/标量）
+#include "simdReduce.h" // 通用 SIMD 归约库：sum/sumSquares/minMax/dot/byteHistogram
+#include "parallelFill.h" // 并行初始化，物理页按“首次访问”分布到各工作线程
+#include "alignedBuffer.h" // 64 字节对齐 + 2MB 大页的分配器与缓冲区
+#include "parallelScan.h" // 两遍、按缓存分块的并行前缀和（inclusive/exclusive，自定义结合运算）
 #include <chrono>
+#include <atomic>
 
 // 计算数组一部分的平方和
 long long partialSum(const std::vector<int>& data, size_t start, size_t end) {
@@ -16,10 +22,14 @@ long long partialSum(const std::vector<int>& data, size_t start, size_t end) {
 int main() {
     // 构造一个大数组
     const size_t dataSize = 10000000;
+    auto start0 = std::chrono::high_resolution_clock::now();
     std::vector<int> data(dataSize);
     for (size_t i = 0; i < dataSize; ++i) {
         data[i] = i % 100;
     }
+    auto end0 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration0 = end0 - start0;
+    std::cout <<"[串行初始化] 总耗时: " << duration0.count() << " 秒.\n";
     // 单线程计算
     auto start1 = std::chrono::high_resolution_clock::now();
     long long res1 = partialSum(std::cref(data), 0, dataSize);
@@ -73,6 +83,39 @@ int main() {
     std::chrono::duration<double> duration2 = end2 - start2;
     std::cout <<"[并行] 计算结果: "<< totalSum <<", 总耗时: " << duration2.count() << " 秒.\n";
 
+    // SIMD + 多线程：每块内部使用运行时分派的 SIMD 内核
+    auto start3 = std::chrono::high_resolution_clock::now();
+    long long res3 = parallelSumSquares(pool, data.data(), dataSize);
+    auto end3 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration3 = end3 - start3;
+    std::cout <<"[SIMD+并行] 计算结果: "<< res3 <<", 总耗时: " << duration3.count() << " 秒, "
+              << dataSize * sizeof(int) / duration3.count() / 1e9 << " GB/s.\n";
+
+    // 并行初始化：每个工作线程首次写入自己的一块，物理页分配在该线程所在的 NUMA 节点上；
+    // 之后用 parallelForPages 按同样的切分（每线程一块，边界对齐到页）做并行计算，各线程大多读取本地节点的内存
+    auto start4 = std::chrono::high_resolution_clock::now();
+    FirstTouchVector<int> data2(dataSize); // 只分配，不写入
+    parallelGenerate(pool, data2.data(), dataSize, [](size_t i) { return static_cast<int>(i % 100); });
+    auto end4 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration4 = end4 - start4;
+    std::cout <<"[并行初始化] 总耗时: " << duration4.count() << " 秒.\n";
+
+    auto start5 = std::chrono::high_resolution_clock::now();
+    std::atomic<long long> res5{0}; // 原子加法按补码回绕，与 SIMD 内核一致
+    parallelForPages(pool, data2.data(), dataSize, 0, [&](size_t s, size_t e) {
+        res5 += sumSquaresKernel()(data2.data() + s, e - s);
+    });
+    auto end5 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration5 = end5 - start5;
+    std::cout <<"[首次访问放置 + SIMD+并行] 计算结果: "<< res5 <<", 总耗时: " << duration5.count() << " 秒, "
+              << dataSize * sizeof(int) / duration5.count() / 1e9 << " GB/s.\n";
+    //benchSumSquares(dataSize); // 各指令集 串行/并行 对比及内存带宽上限
+    //checkSimdReduce();          // SIMD 归约库的正确性检查
+    //benchSimdReduce();          // SIMD 归约库各指令集级别的吞吐
+    //benchHugePages();           // 4KB 页 / 透明大页 / hugetlb 下的扫描与随机访问
+    //checkParallelScan();        // 并行前缀和的正确性检查
+    //benchParallelScan();        // 并行前缀和 vs std::partial_sum / std::inclusive_scan(par)
+
     // 关闭线程池（析构时自动调用）
     return 0;
 }
@@ -0,0 +1,150 @@
+#include "parallelScan.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#ifdef HAVE_PARALLEL_STL
+#include <execution>
+#endif
+
+namespace {
+
+// 不满足交换律的运算：仿射变换 x -> a*x + b 的复合（先 f 后 g），无符号整数溢出按模 2^32 回绕，结果确定
+struct Affine {
+    std::uint32_t a, b;
+    bool operator==(const Affine& o) const { return a == o.a && b == o.b; }
+};
+
+struct ComposeAffine {
+    Affine operator()(const Affine& f, const Affine& g) const { return {g.a * f.a, g.a * f.b + g.b}; }
+};
+
+struct MaxOp {
+    int operator()(int a, int b) const { return a < b ? b : a; }
+};
+
+// 与 std::plus<int> 等价但类型不同，走标量路径，用来衡量 SIMD 块内扫描的收益
+struct PlainPlus {
+    int operator()(int a, int b) const { return a + b; }
+};
+
+template<typename T>
+bool sameScan(const std::vector<T>& a, const std::vector<T>& b) { return a == b; }
+
+bool sameScan(const std::vector<float>& a, const std::vector<float>& b) {
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (std::fabs(a[i] - b[i]) > 1e-3f * (std::fabs(b[i]) + 1)) return false;
+    return true;
+}
+
+template<typename T, typename Op>
+bool checkOne(const char* name, ThreadPool& pool, const std::vector<T>& in, T init, Op op) {
+    const std::size_t n = in.size();
+    std::vector<T> ref(n), out(n);
+    bool ok = true;
+    auto report = [&](const char* what) {
+        std::cout << "(校验失败!) " << name << " " << what << " n=" << n << std::endl;
+        ok = false;
+    };
+    std::partial_sum(in.begin(), in.end(), ref.begin(), op);
+    inclusiveScan(pool, in.data(), out.data(), n, op);
+    if (!sameScan(out, ref)) report("inclusive");
+    out = in;
+    inclusiveScan(pool, out.data(), out.data(), n, op);
+    if (!sameScan(out, ref)) report("inclusive 原地");
+
+    // exclusive 的参考：init, init op in[0], ...
+    T carry = init;
+    for (std::size_t i = 0; i < n; ++i) {
+        ref[i] = carry;
+        carry = op(carry, in[i]);
+    }
+    exclusiveScan(pool, in.data(), out.data(), n, init, op);
+    if (!sameScan(out, ref)) report("exclusive");
+    out = in;
+    exclusiveScan(pool, out.data(), out.data(), n, init, op);
+    if (!sameScan(out, ref)) report("exclusive 原地");
+    return ok;
+}
+
+template<typename F>
+double bestSeconds(F f) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+bool checkParallelScan() {
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency())); // 单核机器上也要走一遍分块路径
+    std::mt19937 rng(20240602);
+    const std::size_t tile = parallel_scan_detail::tileElems<int>();
+    // 覆盖：空输入、不满一个向量、单块（串行路径）、恰好整数块、多轮且最后一轮不满
+    const std::size_t sizes[] = {0, 1, 7, 8, 9, 1000, 2 * tile, 2 * tile + 5, 5 * pool.size() * tile + 12345};
+    bool ok = true;
+    for (std::size_t n : sizes) {
+        std::vector<int> ints(n);
+        std::vector<float> floats(n);
+        std::vector<Affine> affines(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ints[i] = static_cast<int>(rng() % 2001) - 1000;
+            floats[i] = std::uniform_real_distribution<float>(-1.f, 1.f)(rng);
+            affines[i] = {static_cast<std::uint32_t>(rng()) | 1u, static_cast<std::uint32_t>(rng())};
+        }
+        ok = checkOne("plus<int>", pool, ints, 17, std::plus<int>()) && ok;
+        ok = checkOne("plus<>", pool, ints, -3, std::plus<>()) && ok;
+        ok = checkOne("plus<float>", pool, floats, 0.5f, std::plus<float>()) && ok;
+        ok = checkOne("max", pool, ints, INT32_MIN, MaxOp()) && ok;
+        ok = checkOne("affine", pool, affines, Affine{1, 0}, ComposeAffine()) && ok;
+    }
+    std::cout << "并行前缀和正确性检查: " << (ok ? "全部通过" : "存在失败用例") << std::endl;
+    return ok;
+}
+
+void benchParallelScan(std::size_t n) {
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> in(n), ref(n), out(n);
+    // 每 7 个元素之和为 0，前缀和有界，不会溢出
+    for (std::size_t i = 0; i < n; ++i) in[i] = static_cast<int>(i % 7) - 3;
+    const double bytes = 2.0 * n * sizeof(int); // 读一遍输入、写一遍输出
+
+    std::cout << "前缀和基准测试: n = " << n << ", 线程数 = " << pool.size() << std::endl;
+    auto report = [&](const char* name, double sec, bool ok) {
+        std::cout << name << ": " << sec * 1e3 << " ms, " << bytes / sec / 1e9 << " GB/s"
+                  << (ok ? "" : "  (校验失败!)") << std::endl;
+    };
+
+    double sec = bestSeconds([&]() { std::partial_sum(in.begin(), in.end(), ref.begin()); });
+    report("[串行 std::partial_sum]", sec, true);
+
+#ifdef HAVE_PARALLEL_STL
+    sec = bestSeconds([&]() { std::inclusive_scan(std::execution::par, in.begin(), in.end(), out.begin()); });
+    report("[std::inclusive_scan(par)]", sec, out == ref);
+#else
+    std::cout << "[std::inclusive_scan(par)]: 未找到 TBB，跳过" << std::endl;
+#endif
+
+    sec = bestSeconds([&]() { inclusiveScan(pool, in.data(), out.data(), n, PlainPlus()); });
+    report("[inclusiveScan 标量块内扫描]", sec, out == ref);
+
+    std::fill(out.begin(), out.end(), 0);
+    sec = bestSeconds([&]() { inclusiveScan(pool, in.data(), out.data(), n); });
+    report("[inclusiveScan SIMD 块内扫描]", sec, out == ref);
+
+    sec = bestSeconds([&]() { exclusiveScan(pool, in.data(), out.data(), n, 0); });
+    bool ok = n == 0 || out[0] == 0;
+    for (std::size_t i = 1; ok && i < n; ++i) ok = out[i] == ref[i - 1];
+    report("[exclusiveScan SIMD 块内扫描]", sec, ok);
+
+    std::partial_sum(in.begin(), in.end(), ref.begin(), MaxOp());
+    sec = bestSeconds([&]() { inclusiveScan(pool, in.data(), out.data(), n, MaxOp()); });
+    report("[inclusiveScan 自定义运算 max]", sec, out == ref);
+}
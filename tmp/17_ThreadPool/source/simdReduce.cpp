@@ -0,0 +1,161 @@
+#include "simdReduce.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <random>
+
+namespace {
+
+const SimdLevel ALL_LEVELS[] = {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2, SimdLevel::Avx512};
+
+// 参考实现：最直接的顺序循环
+template<typename T>
+MinMaxResult<T> referenceMinMax(const std::vector<T>& v) {
+    MinMaxResult<T> r{v[0], 0, v[0], 0};
+    for (std::size_t i = 1; i < v.size(); ++i) {
+        if (v[i] < r.minValue) r.minValue = v[i], r.minIndex = i;
+        if (v[i] > r.maxValue) r.maxValue = v[i], r.maxIndex = i;
+    }
+    return r;
+}
+
+// 整数结果必须完全相同（INT_MIN/INT_MAX 的平方和会溢出，各实现都按补码回绕）；浮点以 double 累加，不同的累加顺序只会带来舍入级别的差异
+bool sameResult(long long a, long long b, double) { return a == b; }
+bool sameResult(double a, double b, double magnitude) { return std::fabs(a - b) <= 1e-12 * (magnitude + 1); }
+
+template<typename T>
+bool sameMinMax(const MinMaxResult<T>& a, const MinMaxResult<T>& b) {
+    return a.minValue == b.minValue && a.minIndex == b.minIndex && a.maxValue == b.maxValue && a.maxIndex == b.maxIndex;
+}
+
+template<typename T>
+bool checkType(const char* typeName, ThreadPool& pool, std::mt19937& rng) {
+    bool ok = true;
+    // 覆盖：空输入、不满一个向量、恰好整数个向量、带尾部、超过并行阈值
+    const std::size_t sizes[] = {0, 1, 3, 15, 16, 17, 31, 32, 33, 100, 1023, 4097,
+                                 SIMD_REDUCE_PARALLEL_MIN + 5, 3 * SIMD_REDUCE_PARALLEL_MIN + 77};
+    for (std::size_t n : sizes) {
+        std::vector<T> a(n), b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (std::is_same<T, int>::value) {
+                a[i] = static_cast<T>(static_cast<int>(rng()));
+                b[i] = static_cast<T>(static_cast<int>(rng()) % 1000);
+            } else {
+                a[i] = static_cast<T>(std::uniform_real_distribution<float>(-1000.f, 1000.f)(rng));
+                b[i] = static_cast<T>(std::uniform_real_distribution<float>(-1.f, 1.f)(rng));
+            }
+        }
+        if (n > 4) {
+            // 极值与重复的最值：检查 INT_MIN/INT_MAX 的平方以及“相等时取第一个下标”
+            a[n / 3] = std::is_same<T, int>::value ? static_cast<T>(INT_MIN) : static_cast<T>(-1e6f);
+            a[n / 2] = std::is_same<T, int>::value ? static_cast<T>(INT_MAX) : static_cast<T>(1e6f);
+            a[n - 1] = a[n / 3];
+            a[n - 2] = a[n / 2];
+        }
+        using Acc = typename ReduceTraits<T>::Acc;
+        Acc refSum = 0, refSq = 0, refDot = 0;
+        double magnitude = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            refSum = accAdd(refSum, static_cast<Acc>(a[i]));
+            refSq = accAdd(refSq, static_cast<Acc>(a[i]) * a[i]);
+            refDot = accAdd(refDot, static_cast<Acc>(a[i]) * b[i]);
+            magnitude += std::fabs(static_cast<double>(a[i]) * a[i]) + std::fabs(static_cast<double>(a[i]));
+        }
+        for (SimdLevel level : ALL_LEVELS) {
+            if (!simdLevelSupported(level)) continue;
+            for (ThreadPool* p : {static_cast<ThreadPool*>(nullptr), &pool}) {
+                const char* mode = p ? "并行" : "串行";
+                auto report = [&](const char* op) {
+                    std::cout << "(校验失败!) " << typeName << " " << op << " n=" << n << " " << simdLevelName(level)
+                              << " " << mode << std::endl;
+                    ok = false;
+                };
+                if (!sameResult(reduceSum(a.data(), n, p, level), refSum, magnitude)) report("sum");
+                if (!sameResult(reduceSumSquares(a.data(), n, p, level), refSq, magnitude)) report("sumSquares");
+                if (!sameResult(reduceDot(a.data(), b.data(), n, p, level), refDot, magnitude)) report("dot");
+                if (n > 0 && !sameMinMax(reduceMinMax(a.data(), n, p, level), referenceMinMax(a))) report("minMax");
+            }
+        }
+    }
+    return ok;
+}
+
+bool checkHistogram(ThreadPool& pool, std::mt19937& rng) {
+    bool ok = true;
+    for (std::size_t n : {std::size_t(0), std::size_t(7), std::size_t(4099), 2 * SIMD_REDUCE_PARALLEL_MIN + 3}) {
+        std::vector<std::uint8_t> bytes(n);
+        for (auto& x : bytes) x = static_cast<std::uint8_t>(rng() % 7 == 0 ? 0xff : rng());
+        ByteHistogram ref{};
+        for (auto x : bytes) ++ref[x];
+        for (SimdLevel level : ALL_LEVELS) {
+            if (!simdLevelSupported(level)) continue;
+            for (ThreadPool* p : {static_cast<ThreadPool*>(nullptr), &pool}) {
+                if (byteHistogram(bytes.data(), n, p, level) != ref) {
+                    std::cout << "(校验失败!) byteHistogram n=" << n << " " << simdLevelName(level) << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+// 取 5 次中最快的一次，返回 GB/s
+template<typename F>
+double throughput(double bytes, F f) {
+    double best = 1e30;
+    for (int r = 0; r < 5; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return bytes / best / 1e9;
+}
+
+} // namespace
+
+bool checkSimdReduce() {
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency())); // 单核机器上也要走一遍并行分块路径
+    std::mt19937 rng(20240601);
+    bool ok = checkType<int>("int", pool, rng);
+    ok = checkType<float>("float", pool, rng) && ok;
+    ok = checkHistogram(pool, rng) && ok;
+    std::cout << "SIMD 归约正确性检查: " << (ok ? "全部通过" : "存在失败用例") << std::endl;
+    return ok;
+}
+
+void benchSimdReduce(std::size_t n) {
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> ia(n), ib(n);
+    std::vector<float> fa(n), fb(n);
+    std::vector<std::uint8_t> bytes(n * sizeof(int));
+    for (std::size_t i = 0; i < n; ++i) {
+        ia[i] = static_cast<int>(i % 1000) - 500;
+        ib[i] = static_cast<int>(i % 7);
+        fa[i] = static_cast<float>(ia[i]) * 0.5f;
+        fb[i] = static_cast<float>(ib[i]);
+    }
+    for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<std::uint8_t>(i * 2654435761u >> 24);
+
+    const double one = static_cast<double>(n) * sizeof(int); // 单个数组的字节数
+    std::cout << "SIMD 归约吞吐（GB/s），n = " << n << "，线程数 = " << pool.size() << std::endl;
+    for (SimdLevel level : ALL_LEVELS) {
+        if (!simdLevelSupported(level)) {
+            std::cout << simdLevelName(level) << ": CPU 不支持" << std::endl;
+            continue;
+        }
+        for (ThreadPool* p : {static_cast<ThreadPool*>(nullptr), &pool}) {
+            volatile double sink = 0;
+            std::cout << simdLevelName(level) << (p ? " 并行" : " 串行")
+                      << "  sum(int): " << throughput(one, [&]() { sink = reduceSum(ia.data(), n, p, level); })
+                      << "  sum(float): " << throughput(one, [&]() { sink = reduceSum(fa.data(), n, p, level); })
+                      << "  sumSquares(int): " << throughput(one, [&]() { sink = reduceSumSquares(ia.data(), n, p, level); })
+                      << "  dot(float): " << throughput(2 * one, [&]() { sink = reduceDot(fa.data(), fb.data(), n, p, level); })
+                      << "  minMax(int): " << throughput(one, [&]() { sink = reduceMinMax(ia.data(), n, p, level).minValue; })
+                      << "  minMax(float): " << throughput(one, [&]() { sink = reduceMinMax(fa.data(), n, p, level).maxValue; })
+                      << "  byteHistogram: " << throughput(one, [&]() { sink = byteHistogram(bytes.data(), bytes.size(), p, level)[0]; })
+                      << std::endl;
+        }
+    }
+}
@@ -0,0 +1,215 @@
+#include "sumSquares.h"
+#include <algorithm>
+#include <chrono>
+#include <immintrin.h>
+#include <unistd.h>
+
+// 单个平方不超过 2^62 不会溢出，累加用无符号加法：溢出时按补码回绕而不是未定义行为，各内核结果一致
+long long sumSquaresScalar(const int* data, std::size_t n) {
+    unsigned long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        sum += static_cast<unsigned long long>(static_cast<long long>(data[i]) * data[i]);
+    return static_cast<long long>(sum);
+}
+
+__attribute__((target("sse2")))
+long long sumSquaresSse2(const int* data, std::size_t n) {
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 4));
+        // |x| = (x ^ s) - s，s 为符号位扩展；INT_MIN 的绝对值按无符号解释正好是 2^31
+        __m128i sa = _mm_srai_epi32(a, 31), sb = _mm_srai_epi32(b, 31);
+        a = _mm_sub_epi32(_mm_xor_si128(a, sa), sa);
+        b = _mm_sub_epi32(_mm_xor_si128(b, sb), sb);
+        acc0 = _mm_add_epi64(acc0, _mm_mul_epu32(a, a));                                       // 元素 0、2
+        acc0 = _mm_add_epi64(acc0, _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(a, 32))); // 元素 1、3
+        acc1 = _mm_add_epi64(acc1, _mm_mul_epu32(b, b));
+        acc1 = _mm_add_epi64(acc1, _mm_mul_epu32(_mm_srli_epi64(b, 32), _mm_srli_epi64(b, 32)));
+    }
+    alignas(16) unsigned long long lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc0, acc1));
+    unsigned long long sum = lanes[0] + lanes[1];
+    return static_cast<long long>(sum + static_cast<unsigned long long>(sumSquaresScalar(data + i, n - i)));
+}
+
+__attribute__((target("avx2")))
+long long sumSquaresAvx2(const int* data, std::size_t n) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+        // _mm256_mul_epi32 只取每个 64 位通道的低 32 位（有符号）相乘：先算偶数位置，右移后再算奇数位置
+        __m256i ao = _mm256_srli_epi64(a, 32), bo = _mm256_srli_epi64(b, 32);
+        acc0 = _mm256_add_epi64(acc0, _mm256_mul_epi32(a, a));
+        acc0 = _mm256_add_epi64(acc0, _mm256_mul_epi32(ao, ao));
+        acc1 = _mm256_add_epi64(acc1, _mm256_mul_epi32(b, b));
+        acc1 = _mm256_add_epi64(acc1, _mm256_mul_epi32(bo, bo));
+    }
+    alignas(32) unsigned long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    unsigned long long sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return static_cast<long long>(sum + static_cast<unsigned long long>(sumSquaresScalar(data + i, n - i)));
+}
+
+__attribute__((target("avx512f")))
+long long sumSquaresAvx512(const int* data, std::size_t n) {
+    __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i a = _mm512_loadu_si512(data + i);
+        __m512i b = _mm512_loadu_si512(data + i + 16);
+        __m512i ao = _mm512_srli_epi64(a, 32), bo = _mm512_srli_epi64(b, 32);
+        acc0 = _mm512_add_epi64(acc0, _mm512_mul_epi32(a, a));
+        acc0 = _mm512_add_epi64(acc0, _mm512_mul_epi32(ao, ao));
+        acc1 = _mm512_add_epi64(acc1, _mm512_mul_epi32(b, b));
+        acc1 = _mm512_add_epi64(acc1, _mm512_mul_epi32(bo, bo));
+    }
+    // 不用 _mm512_reduce_add_epi64：它内部是有符号加法，溢出时是未定义行为
+    alignas(64) unsigned long long lanes[8];
+    _mm512_store_si512(lanes, _mm512_add_epi64(acc0, acc1));
+    unsigned long long sum = 0;
+    for (unsigned long long lane : lanes) sum += lane;
+    return static_cast<long long>(sum + static_cast<unsigned long long>(sumSquaresScalar(data + i, n - i)));
+}
+
+std::vector<SumSquaresIsa> sumSquaresIsaList() {
+    __builtin_cpu_init();
+    return {
+        {"scalar", sumSquaresScalar, true},
+        {"SSE2", sumSquaresSse2, static_cast<bool>(__builtin_cpu_supports("sse2"))},
+        {"AVX2", sumSquaresAvx2, static_cast<bool>(__builtin_cpu_supports("avx2"))},
+        {"AVX-512", sumSquaresAvx512, static_cast<bool>(__builtin_cpu_supports("avx512f"))},
+    };
+}
+
+SumSquaresKernel sumSquaresKernel() {
+    static const SumSquaresKernel best = []() {
+        SumSquaresKernel k = sumSquaresScalar;
+        for (const auto& isa : sumSquaresIsaList())
+            if (isa.supported) k = isa.kernel;
+        return k;
+    }();
+    return best;
+}
+
+long long parallelSumSquares(ThreadPool& pool, const int* data, std::size_t n,
+                             SumSquaresKernel kernel, std::size_t blocks) {
+    if (blocks == 0) blocks = std::max<std::size_t>(1, pool.size() * 4);
+    // 块边界按 16 个 int（64 字节）对齐，避免相邻块共用缓存行，也让每块的 SIMD 主循环更完整
+    std::size_t blockSize = (n / blocks + 15) & ~static_cast<std::size_t>(15);
+    if (blockSize == 0) blockSize = n;
+    std::vector<std::future<long long>> futures;
+    for (std::size_t start = 0; start < n; start += blockSize)
+        futures.push_back(pool.enqueue(kernel, data + start, std::min(blockSize, n - start)));
+    unsigned long long total = 0; // 与内核一样按补码回绕
+    for (auto& fut : futures) total += static_cast<unsigned long long>(fut.get());
+    return static_cast<long long>(total);
+}
+
+namespace {
+
+// 取 reps 次中最快的一次，单位秒
+template<typename F>
+double bestOf(int reps, F f) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// 只读不算：按位或归约，用来测量“读”带宽，即平方和能达到的上限
+__attribute__((target("avx2")))
+unsigned long long orReduceAvx2(const int* data, std::size_t n) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_or_si256(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        acc1 = _mm256_or_si256(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8)));
+    }
+    alignas(32) unsigned long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_or_si256(acc0, acc1));
+    unsigned long long r = lanes[0] | lanes[1] | lanes[2] | lanes[3];
+    for (; i < n; ++i) r |= static_cast<unsigned int>(data[i]);
+    return r;
+}
+
+__attribute__((target("avx512f")))
+unsigned long long orReduceAvx512(const int* data, std::size_t n) {
+    __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_or_si512(acc0, _mm512_loadu_si512(data + i));
+        acc1 = _mm512_or_si512(acc1, _mm512_loadu_si512(data + i + 16));
+    }
+    unsigned long long r = static_cast<unsigned long long>(_mm512_reduce_or_epi64(_mm512_or_si512(acc0, acc1)));
+    for (; i < n; ++i) r |= static_cast<unsigned int>(data[i]);
+    return r;
+}
+
+unsigned long long orReduceScalar(const int* data, std::size_t n) {
+    unsigned long long r = 0;
+    for (std::size_t i = 0; i < n; ++i) r |= static_cast<unsigned int>(data[i]);
+    return r;
+}
+
+// 并行内存读带宽（GB/s）：用最宽的 SIMD 内核只读不算，缓冲区取末级缓存的 4 倍（至少与数据一样大），
+// 保证读的是内存而不是缓存；读得比平方和内核慢的话，这个“上限”就不成立了
+double measureReadBandwidth(ThreadPool& pool, std::size_t dataBytes) {
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    std::size_t bytes = std::max(dataBytes, 4 * (llc > 0 ? static_cast<std::size_t>(llc) : std::size_t(32) << 20));
+    bytes = std::min(bytes, std::size_t(2) << 30);
+    std::vector<int> buffer(bytes / sizeof(int), 1); // 写一遍，确保每一页都真正分配
+    auto kernel = __builtin_cpu_supports("avx512f") ? orReduceAvx512
+                : __builtin_cpu_supports("avx2")    ? orReduceAvx2
+                                                    : orReduceScalar;
+    std::size_t blocks = std::max<std::size_t>(1, pool.size() * 4);
+    std::size_t blockSize = (buffer.size() + blocks - 1) / blocks;
+    unsigned long long sink = 0;
+    double seconds = bestOf(3, [&]() {
+        std::vector<std::future<unsigned long long>> futures;
+        for (std::size_t start = 0; start < buffer.size(); start += blockSize)
+            futures.push_back(pool.enqueue(kernel, buffer.data() + start, std::min(blockSize, buffer.size() - start)));
+        for (auto& fut : futures) sink |= fut.get();
+    });
+    volatile unsigned long long keep = sink; // 防止归约被优化掉
+    (void)keep;
+    return buffer.size() * sizeof(int) / seconds / 1e9;
+}
+
+} // namespace
+
+void benchSumSquares(std::size_t dataSize) {
+    std::vector<int> data(dataSize);
+    for (std::size_t i = 0; i < dataSize; ++i)
+        data[i] = static_cast<int>(i % 100) - 50;
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+    const double bytes = static_cast<double>(dataSize) * sizeof(int);
+    const double roofline = measureReadBandwidth(pool, dataSize * sizeof(int));
+    const long long expected = sumSquaresScalar(data.data(), dataSize);
+    std::cout << "平方和基准测试: " << dataSize << " 个 int（" << bytes / 1e6 << " MB）, 线程数 = " << pool.size()
+              << ", 内存读带宽上限 ≈ " << roofline << " GB/s" << std::endl;
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc > 0 && bytes <= static_cast<double>(llc))
+        std::cout << "（数据能放进末级缓存（" << llc / 1e6 << " MB），重复计算时读的是缓存，百分比可以超过 100%）" << std::endl;
+    for (const auto& isa : sumSquaresIsaList()) {
+        if (!isa.supported) {
+            std::cout << isa.name << ": CPU 不支持" << std::endl;
+            continue;
+        }
+        long long serialRes = 0, parallelRes = 0;
+        double serial = bestOf(5, [&]() { serialRes = isa.kernel(data.data(), dataSize); });
+        double parallel = bestOf(5, [&]() { parallelRes = parallelSumSquares(pool, data.data(), dataSize, isa.kernel); });
+        std::cout << isa.name << "  串行: " << serial * 1e3 << " ms, " << bytes / serial / 1e9 << " GB/s"
+                  << "  并行: " << parallel * 1e3 << " ms, " << bytes / parallel / 1e9 << " GB/s ("
+                  << 100.0 * bytes / parallel / 1e9 / roofline << "% 带宽上限)"
+                  << (serialRes == expected && parallelRes == expected ? "" : "  (校验失败!)") << std::endl;
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef __COMPLETIONEVENT__H__
+#define __COMPLETIONEVENT__H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/*
+Deadline 与 CompletionEvent：替代“轮询 + sleep_for”的超时等待
+    testOvertime 每 100ms 醒来检查一次 taskDone：任务完成后最多还要等 100ms 才能发现，
+并且任务没完成时 CPU 也会被周期性唤醒。
+    1. Deadline：基于 steady_clock 的截止时间点，不受系统时间调整影响，可以在多次等待之间传递剩余时间。
+    2. CompletionEvent：原子标志 + 等待队列。
+        set()：标志置 1，只有在有线程睡眠时才唤醒；
+        wait_until(deadline)：标志已置位立即返回 true，否则睡到“被 set 唤醒”或“截止时间到达”为止。
+    Linux 下直接用 futex 睡在标志字上：FUTEX_WAIT_BITSET 接受 CLOCK_MONOTONIC 的绝对时间，
+而 libstdc++ 的 steady_clock 正是 CLOCK_MONOTONIC，所以截止时间无需换算成相对时长，也不会因为重试而累积误差。
+其他平台退化为 mutex + condition_variable。
+*/
+
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    template<typename Rep, typename Period>
+    explicit Deadline(std::chrono::duration<Rep, Period> timeout)
+        : when(Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout)) {}
+    explicit Deadline(Clock::time_point tp) : when(tp) {}
+
+    Clock::time_point timePoint() const { return when; }
+    bool expired() const { return Clock::now() >= when; }
+    Clock::duration remaining() const {
+        auto left = when - Clock::now();
+        return left > Clock::duration::zero() ? left : Clock::duration::zero();
+    }
+
+private:
+    Clock::time_point when;
+};
+
+class CompletionEvent {
+public:
+    CompletionEvent() = default;
+    CompletionEvent(const CompletionEvent&) = delete;
+    CompletionEvent& operator=(const CompletionEvent&) = delete;
+
+    bool isSet() const { return state.load(std::memory_order_acquire) & SET; }
+
+    void set() {
+#ifdef __linux__
+        if (state.exchange(SET, std::memory_order_acq_rel) & WAITER)
+            syscall(SYS_futex, word(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+        {
+            std::lock_guard<std::mutex> lock(m);
+            state.store(SET, std::memory_order_release);
+        }
+        cv.notify_all();
+#endif
+    }
+
+    // 重新置为未完成，只能在没有线程等待时调用
+    void reset() { state.store(0, std::memory_order_relaxed); }
+
+    void wait() { wait_until(Deadline(Deadline::Clock::time_point::max())); }
+
+    template<typename Rep, typename Period>
+    bool wait_for(std::chrono::duration<Rep, Period> timeout) { return wait_until(Deadline(timeout)); }
+
+    // 返回 true 表示事件已完成，false 表示截止时间已到
+    bool wait_until(const Deadline& deadline) {
+        if (isSet()) return true;
+#ifdef __linux__
+        const bool forever = deadline.timePoint() == Deadline::Clock::time_point::max();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.timePoint().time_since_epoch()).count();
+        timespec abs{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        std::uint32_t s = state.load(std::memory_order_acquire);
+        while (!(s & SET)) {
+            if (!forever && deadline.expired()) return false;
+            // 先声明“有人在睡”，set 看到 WAITER 位才会发起唤醒
+            if (s == 0 && !state.compare_exchange_weak(s, WAITER, std::memory_order_acquire))
+                continue;
+            syscall(SYS_futex, word(), FUTEX_WAIT_BITSET_PRIVATE, WAITER,
+                    forever ? nullptr : &abs, nullptr, FUTEX_BITSET_MATCH_ANY);
+            s = state.load(std::memory_order_acquire);
+        }
+        return true;
+#else
+        std::unique_lock<std::mutex> lock(m);
+        return cv.wait_until(lock, deadline.timePoint(), [this]() { return isSet(); });
+#endif
+    }
+
+private:
+    enum : std::uint32_t { SET = 1, WAITER = 2 };
+
+#ifdef __linux__
+    std::uint32_t* word() { return reinterpret_cast<std::uint32_t*>(&state); }
+#else
+    std::mutex m;
+    std::condition_variable cv;
+#endif
+    std::atomic<std::uint32_t> state{0};
+};
+
+#endif
@@ -143,11 +143,63 @@ void testOvertime(){
                 std::cout << "Timeout!\n";
                 break;
             }
-            std::this_thread::sleep_for(100ms);
+            std::this_thread::sleep_for(100ms);//任务完成后最多要 100ms 才能发现，且会周期性唤醒 CPU
         }
     }
     t.join();
 }
+// 改进：任务完成时主动唤醒等待方（见 completionEvent.h），到截止时间仍未完成则超时返回
+#include "completionEvent.h"
+CompletionEvent taskEvent;
+void sideThread2(){
+    std::this_thread::sleep_for(5s); // 模拟工作
+    taskEvent.set();
+}
+
+void testOvertime2(){
+    std::thread t(sideThread2);
+    Deadline deadline(3s);
+    if(!taskEvent.wait_until(deadline)){
+        std::cout << "Timeout!\n";
+    }
+    t.join();
+}
+// 唤醒延迟对比：任务完成（置位）到等待方醒来之间的时间
+void testWakeupLatency(){
+    const int rounds = 20;
+    double pollUs = 0, eventUs = 0;
+    for(int i = 0; i < rounds; ++i){
+        std::atomic<bool> done(false);
+        std::atomic<long long> doneAt(0);
+        std::thread worker([&](){
+            std::this_thread::sleep_for(std::chrono::milliseconds(7 * i % 50 + 1));
+            doneAt = std::chrono::steady_clock::now().time_since_epoch().count();
+            done = true;
+        });
+        while(!done) std::this_thread::sleep_for(100ms);
+        pollUs += (std::chrono::steady_clock::now().time_since_epoch().count() - doneAt) / 1000.0;
+        worker.join();
+
+        CompletionEvent event;
+        std::thread worker2([&](){
+            std::this_thread::sleep_for(std::chrono::milliseconds(7 * i % 50 + 1));
+            doneAt = std::chrono::steady_clock::now().time_since_epoch().count();
+            event.set();
+        });
+        event.wait_until(Deadline(3s));
+        eventUs += (std::chrono::steady_clock::now().time_since_epoch().count() - doneAt) / 1000.0;
+        worker2.join();
+    }
+    std::cout << "average wakeup latency, polling every 100ms: " << pollUs / rounds << " us\n";
+    std::cout << "average wakeup latency, CompletionEvent:     " << eventUs / rounds << " us\n";
+
+    CompletionEvent never;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = never.wait_for(20ms);
+    std::cout << "wait_for(20ms) returned " << (ok ? "set" : "timeout") << " after "
+              << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()
+              << " us\n";
+}
 /*
 三、namespace
 1. 基本概念
@@ -229,6 +281,8 @@ int main(){
     //test();
     //computeTime();
     testOvertime();
+    //testOvertime2();
+    //testWakeupLatency();
     return 0;
 }
 